@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "wide_integers.h"
+
+namespace pascal
+{
+    // Turns C(n, k - 1) into C(n, k), since C(n, k) = C(n, k - 1) * (n - k + 1) / k
+    template<typename T>
+    void next_binomial(T& entry, uint64_t n, uint64_t k)
+    {
+        if constexpr (std::integral<T>)
+        {
+            // Divide first, so nothing bigger than the answer is ever made.
+            // entry * (n - k + 1) is a multiple of k, so k / g divides n - k + 1
+            const T g = std::gcd(entry, static_cast<T>(k));
+            entry = entry / g * (static_cast<T>(n - k + 1) / (static_cast<T>(k) / g));
+        }
+        else
+        {
+            // entry * (n - k + 1) could be far bigger than the answer, and wrap for UInt128.
+            // With entry = q * k + r, the answer is q * (n - k + 1) + r * (n - k + 1) / k.
+            // k must be below 2^32, but n can be anything.
+            const uint64_t factor = n - k + 1;
+            T share{ entry.divide(static_cast<uint32_t>(k)) };
+            share *= factor;
+            share /= static_cast<uint32_t>(k);
+            entry *= factor;
+            entry += share;
+        }
+    }
+
+    // Row n, counting from zero, without making the rows above it.
+    // Rows are palindromes, so we only work out the first half.
+    template<typename T = int>
+    std::vector<T> pascal_row(uint64_t n)
+    {
+        std::vector<T> row(n + 1);
+        T entry = 1;
+        row[0] = entry;
+        for (uint64_t k = 1; k <= n / 2; ++k)
+        {
+            next_binomial(entry, n, k);
+            row[k] = entry;
+        }
+        std::copy(row.begin(), row.begin() + (n + 1) / 2, row.rbegin());
+        return row;
+    }
+
+    // Entry k of row n, in O(min(k, n - k)) steps.
+    // For UInt128 and BigUnsigned, min(k, n - k) must be below 2^32; n can be any size.
+    template<typename T = int>
+    T pascal_entry(uint64_t n, uint64_t k)
+    {
+        if (k > n)
+        {
+            return 0;
+        }
+        k = std::min(k, n - k);
+        if (!std::integral<T> && k > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::out_of_range("pascal_entry: min(k, n - k) must be below 2^32");
+        }
+        T entry = 1;
+        for (uint64_t i = 1; i <= k; ++i)
+        {
+            next_binomial(entry, n, i);
+        }
+        return entry;
+    }
+
+    // Modular versions, for a prime p below 2^32, so products of two residues fit in 64 bits
+    namespace detail
+    {
+        constexpr uint64_t power_mod(uint64_t base, uint64_t exponent, uint64_t p)
+        {
+            uint64_t result = 1;
+            base %= p;
+            while (exponent)
+            {
+                if (exponent & 1)
+                {
+                    result = result * base % p;
+                }
+                base = base * base % p;
+                exponent >>= 1;
+            }
+            return result;
+        }
+
+        // C(n, k) mod p for k <= n < p, where k! is not a multiple of p so has an inverse
+        constexpr uint64_t small_binomial_mod(uint64_t n, uint64_t k, uint64_t p)
+        {
+            k = std::min(k, n - k);
+            uint64_t numerator = 1;
+            uint64_t denominator = 1;
+            for (uint64_t i = 1; i <= k; ++i)
+            {
+                numerator = numerator * ((n - k + i) % p) % p;
+                denominator = denominator * i % p;
+            }
+            return numerator * power_mod(denominator, p - 2, p) % p; // Fermat's little theorem
+        }
+    }
+
+    // C(n, k) mod p, using Lucas' theorem:
+    // the product of C(n_i, k_i) for the base p digits n_i and k_i of n and k
+    constexpr uint32_t pascal_entry_mod(uint64_t n, uint64_t k, uint32_t p)
+    {
+        if (k > n)
+        {
+            return 0;
+        }
+        uint64_t result = 1;
+        while (k && result)
+        {
+            const uint64_t n_digit = n % p;
+            const uint64_t k_digit = k % p;
+            if (k_digit > n_digit)
+            {
+                return 0;
+            }
+            result = result * detail::small_binomial_mod(n_digit, k_digit, p) % p;
+            n /= p;
+            k /= p;
+        }
+        return static_cast<uint32_t>(result);
+    }
+
+    // Row n mod p, with factorial tables for digits below p shared by every entry
+    inline std::vector<uint32_t> pascal_row_mod(uint64_t n, uint32_t p)
+    {
+        const uint64_t table_size = std::min<uint64_t>(n + 1, p);
+        std::vector<uint64_t> factorial(table_size, 1);
+        for (uint64_t i = 1; i < table_size; ++i)
+        {
+            factorial[i] = factorial[i - 1] * i % p;
+        }
+        std::vector<uint64_t> inverse_factorial(table_size, 1);
+        inverse_factorial.back() = detail::power_mod(factorial.back(), p - 2, p);
+        for (uint64_t i = table_size - 1; i > 0; --i)
+        {
+            inverse_factorial[i - 1] = inverse_factorial[i] * i % p;
+        }
+
+        std::vector<uint32_t> row(n + 1);
+        for (uint64_t k = 0; k <= n / 2; ++k)
+        {
+            uint64_t result = 1;
+            for (uint64_t top = n, bottom = k; bottom && result; top /= p, bottom /= p)
+            {
+                const uint64_t n_digit = top % p;
+                const uint64_t k_digit = bottom % p;
+                result = k_digit > n_digit ? 0
+                    : result * factorial[n_digit] % p
+                        * inverse_factorial[k_digit] % p
+                        * inverse_factorial[n_digit - k_digit] % p;
+            }
+            row[k] = static_cast<uint32_t>(result);
+            row[n - k] = row[k];
+        }
+        return row;
+    }
+}
@@ -1,14 +1,27 @@
 #include <cassert>
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <iterator>
 #include <format>
 #include <functional>
 #include <numeric>
+#include <sstream>
 #include <ranges>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "binomial.h"
+#include "pascal_triangle.h"
+#include "row_kernels.h"
+#include "row_validator.h"
+#include "sierpinski.h"
+#include "triangle_table.h"
+#include "triangle_writer.h"
+
 // In Visual Studio add /std:c++latest to 'properties | C++ | command line | additon options' to get the CTAD, ranges etc
 // Or at least C++17 for --std in g++ (CTAD has been around since C++17)
 
@@ -69,8 +82,10 @@ std::ostream& operator << (std::ostream & s,
 }
 
 // Listing 2.7 Center justified output
+// The listings take a std::vector<std::vector<int>>
+//  but any pascal::Triangle, including the flat PascalTriangle, works too
 void show_vectors(std::ostream& s,
-    const std::vector<std::vector<int>>& v)
+    const pascal::Triangle auto& v)
 {
     size_t final_row_size = v.back().size();
     std::string spaces(final_row_size * 3, ' ');
@@ -91,7 +106,7 @@ void show_vectors(std::ostream& s,
 //  Recall, 6 is fine for 16 or so rows. 
 //  Once the entries are more than 4 digits the will overlap
 void show_vectors_more_general(std::ostream& s,
-    const std::vector<std::vector<int>>& v, size_t width = 6)
+    const pascal::Triangle auto& v, size_t width = 6)
 {
     const auto gaps  = width/2;
     std::string spaces(v.back().size() * gaps, ' ');
@@ -111,7 +126,8 @@ void show_vectors_more_general(std::ostream& s,
 // Based on
 // https://en.cppreference.com/w/cpp/algorithm/ranges/equal
 // contexpr not mentioned in the text
-constexpr bool is_palindrome(const std::vector<int>& v)
+// Takes any sized range, so a std::span row from a PascalTriangle works too
+constexpr bool is_palindrome(const std::ranges::sized_range auto& v)
 {
     auto forward = v | std::views::take(v.size() / 2);
     auto backward = v | std::views::reverse | std::views::take(v.size() / 2);
@@ -120,9 +136,10 @@ constexpr bool is_palindrome(const std::vector<int>& v)
 
 // Some tests, using assert
 // fails for a 36 row triangle - think about why
-void check_properties(const std::vector<std::vector<int>> & triangle)
+// int runs out after pascal::max_rows<int>() rows, but the element type can be wider
+void check_properties(const pascal::Triangle auto & triangle)
 {
-    int expected_total = 1;
+    pascal::element_t<decltype(triangle)> expected_total = 1;
     size_t row_number = 1;
     for (const auto & row : triangle)
     {
@@ -132,15 +149,15 @@ void check_properties(const std::vector<std::vector<int>> & triangle)
 
         assert(std::accumulate(row.begin(),
             row.end(),
-            0)
+            decltype(expected_total){})
             == expected_total);
 
-        expected_total *= 2;
+        expected_total += expected_total;
 
         // symmetry
         assert(is_palindrome(row));
 
-        auto negative = [](int x) { return x < 0; };
+        auto negative = [](auto x) { return x < 0; };
         auto negatives = row | std::views::filter(negative);
         assert(negatives.empty());
     }
@@ -148,7 +165,7 @@ void check_properties(const std::vector<std::vector<int>> & triangle)
 
 //Listing 2.16 Show odd numbers as stars
 void show_view(std::ostream& s,
-    const std::vector<std::vector<int>>& v)
+    const pascal::Triangle auto& v)
 {
     const auto gaps = 1;
     std::string spaces(v.back().size() * gaps, ' ');
@@ -166,9 +183,74 @@ void show_view(std::ostream& s,
     }
 }
 
+// Not in the text: times get_next_row against the vectorised kernels.
+// The rows hold small numbers, since we're timing the additions
+//  and real rows this long would overflow int.
+void benchmark_next_row(std::ostream& s)
+{
+    using namespace std::chrono;
+    for (size_t size : { 1'000, 10'000, 100'000 })
+    {
+        std::vector<int> last_row(size);
+        for (size_t idx = 0; idx < size; ++idx)
+        {
+            last_row[idx] = static_cast<int>(idx % 1000);
+        }
+        const size_t repeats = 100'000'000 / size;
+        long long checksum = 0;
+
+        auto start = steady_clock::now();
+        for (size_t i = 0; i < repeats; ++i)
+        {
+            checksum += get_next_row(last_row)[size / 2];
+        }
+        duration<double, std::micro> per_row = (steady_clock::now() - start) / repeats;
+        s << std::format("{:>7} entries: get_next_row {:>8.2f}us", size, per_row.count());
+
+        std::vector<int> next_row(size + 1);
+        for (auto kernel : { pascal::Kernel::Scalar, pascal::Kernel::SSE2, pascal::Kernel::AVX2 })
+        {
+            if (!pascal::kernel_supported(kernel))
+            {
+                continue;
+            }
+            start = steady_clock::now();
+            for (size_t i = 0; i < repeats; ++i)
+            {
+                pascal::add_adjacent(last_row, next_row, kernel);
+                checksum += next_row[size / 2];
+            }
+            per_row = (steady_clock::now() - start) / repeats;
+            s << std::format(", {} {:>8.2f}us", pascal::to_string(kernel), per_row.count());
+        }
+        s << std::format(" (checksum {})\n", checksum);
+    }
+}
+
+// Not in the text: times building a triangle in blocks of rows on more and more threads.
+// BigUnsigned, so the rows are tall enough to be worth sharing out without overflowing.
+void benchmark_parallel_triangle(std::ostream& s, size_t rows = 1'000)
+{
+    using namespace std::chrono;
+    auto start = steady_clock::now();
+    pascal::PascalTriangle<pascal::BigUnsigned> sequential(rows);
+    duration<double, std::milli> taken = steady_clock::now() - start;
+    s << std::format("{} rows, sequential: {:.1f}ms\n", rows, taken.count());
+
+    const unsigned most_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned threads = 1; threads <= most_threads; threads *= 2)
+    {
+        start = steady_clock::now();
+        pascal::PascalTriangle<pascal::BigUnsigned> parallel(rows, threads);
+        taken = steady_clock::now() - start;
+        assert(std::ranges::equal(parallel.data(), sequential.data()));
+        s << std::format("{} rows, {:>3} threads: {:.1f}ms\n", rows, threads, taken.count());
+    }
+}
 
 //Pulls together all the listing gradually added to main through the text
-int main()
+// Run with --bench to time the faster ways of making rows too
+int main(int argc, char* argv[])
 {
     auto triangle = generate_triangle(16); //Change 16 if you want
 
@@ -188,5 +270,127 @@ int main()
 
     // Show odd numbers as stars
     show_view(std::cout, triangle);
+
+    // The same triangle, in one contiguous buffer
+    pascal::PascalTriangle flat(triangle.size());
+    assert(std::ranges::equal(flat, triangle, std::ranges::equal));
+    check_properties(flat);
+
+    // Or one row at a time, reusing a single buffer
+    size_t row_number = 0;
+    for (auto row : pascal::rows(triangle.size()))
+    {
+        assert(std::ranges::equal(row, triangle[row_number++]));
+    }
+    assert(pascal::nth_row(triangle.size() - 1) == triangle.back());
+
+    // Checked as the rows go past, rather than keeping them for check_properties
+    pascal::RowValidator validator;
+    for (auto row : pascal::rows(triangle.size()))
+    {
+        validator.push(row);
+    }
+    assert(validator.ok());
+
+    // A bad row stops the checking, and later rows are ignored
+    auto spoilt = [&triangle](size_t bad_row, std::vector<int> replacement) {
+        pascal::RowValidator checker;
+        for (size_t idx = 0; idx < triangle.size(); ++idx)
+        {
+            const bool pushed = checker.push(idx == bad_row ? replacement : triangle[idx]);
+            assert(pushed == (idx < bad_row));
+        }
+        assert(!checker.ok() && checker.rows_checked() == bad_row);
+        assert(checker.first_bad_row() == bad_row);
+        return checker.problem();
+    };
+    assert(spoilt(4, { 1, 4, 7, 4, 1 }) == pascal::RowProblem::WrongTotal);
+    assert(spoilt(4, { 1, 3, 7, 4, 1 }) == pascal::RowProblem::NotSymmetric);
+
+    // Too tall for int, so this uses a wider type
+    auto tall = pascal::generate_wide_enough(100);
+    std::visit([](const auto& t) { check_properties(t); }, tall);
+    assert(std::holds_alternative<pascal::PascalTriangle<pascal::UInt128>>(tall));
+
+    // Any row or entry, without the rows above it
+    assert(pascal::pascal_row(triangle.size() - 1) == triangle.back());
+    assert(pascal::pascal_entry(15, 7) == 6435);
+    assert(to_string(pascal::pascal_entry<pascal::BigUnsigned>(5'000'000'000, 2)) == "12499999997500000000");
+    assert(pascal::pascal_entry_mod(15, 7, 13) == 6435 % 13);
+    // A whole row at once gives the same entries, for p smaller than n and for p bigger
+    for (uint32_t p : { 13u, 101u })
+    {
+        const auto row_mod = pascal::pascal_row_mod(100, p);
+        assert(row_mod.size() == 101);
+        for (uint64_t k = 0; k <= 100; ++k)
+        {
+            assert(row_mod[k] == pascal::pascal_entry_mod(100, k, p));
+        }
+    }
+    std::cout << "C(10000, 5000) mod 1000003 is " << pascal::pascal_entry_mod(10000, 5000, 1000003) << '\n';
+
+    // The vectorised kernel makes the same rows as get_next_row
+    std::vector<int> row;
+    for (const auto& expected : triangle)
+    {
+        std::vector<int> next(row.size() + 1);
+        pascal::add_adjacent(row, next);
+        assert(next == expected);
+        row = std::move(next);
+    }
+
+    // The same rows made by the compiler, with their properties checked by static_asserts in triangle_table.h
+    static_assert(is_palindrome(pascal::triangle_table<16>.back()));
+    assert(std::ranges::equal(pascal::triangle_table<16>, triangle, std::ranges::equal));
+    check_properties(pascal::triangle_table<16>);
+
+    // Blocks of rows, shared between threads
+    pascal::PascalTriangle parallel(triangle.size(), 4);
+    assert(std::ranges::equal(parallel, triangle, std::ranges::equal));
+    // Enough threads that blocks start from rows near the top of what UInt128 holds
+    const auto wide_rows = pascal::max_rows<pascal::UInt128>();
+    pascal::PascalTriangle<pascal::UInt128> wide_parallel(wide_rows, 64);
+    assert(std::ranges::equal(wide_parallel, pascal::PascalTriangle<pascal::UInt128>(wide_rows), std::ranges::equal));
+    assert(pascal::pascal_entry<pascal::UInt128>(126, 63) == pascal::PascalTriangle<pascal::UInt128>(127).back()[63]);
+
+    // The same output as show_vectors_more_general, from one buffer
+    pascal::TriangleWriter writer;
+    auto same_as_writer = [&writer](const auto& v, size_t width) {
+        std::ostringstream expected, written;
+        show_vectors_more_general(expected, v, width);
+        writer.write(written, v, width);
+        return expected.str() == written.str();
+    };
+    assert(same_as_writer(triangle, pascal::TriangleWriter::width_needed(triangle)));
+    std::ostringstream shown, written;
+    show_vectors(shown, triangle);
+    writer.write(written, triangle);
+    assert(shown.str() == written.str());
+    const pascal::PascalTriangle<pascal::BigUnsigned> big(40);
+    assert(same_as_writer(big, pascal::TriangleWriter::width_needed(big)));
+
+    // The odd numbers as stars again, working mod 2 so we don't need the numbers.
+    // For a picture, try
+    //     std::ofstream file("sierpinski.pbm", std::ios::binary);
+    //     pascal::write_pbm(file, 4096);
+    std::ostringstream stars, parity;
+    show_view(stars, triangle);
+    pascal::show_parity(parity, triangle.size());
+    assert(stars.str() == parity.str());
+    // And as a PBM image, with the leftmost pixel in each byte's top bit
+    std::ostringstream small_pbm;
+    pascal::write_pbm(small_pbm, 4);
+    assert(small_pbm.str() == "P4\n4 4\n\x80\xC0\xA0\xF0");
+    // Rows wider than a byte: row 8 is odd only at each end, in the second byte's top bit
+    std::ostringstream wider_pbm;
+    pascal::write_pbm(wider_pbm, 9);
+    assert(wider_pbm.str().ends_with("\x80\x80"));
+    assert(wider_pbm.str().size() == std::string_view("P4\n9 9\n").size() + 9 * 2);
+
+    if (argc > 1 && std::string_view(argv[1]) == "--bench")
+    {
+        benchmark_next_row(std::cout);
+        benchmark_parallel_triangle(std::cout);
+    }
 }
 
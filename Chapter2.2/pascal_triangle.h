@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "binomial.h"
+#include "wide_integers.h"
+
+namespace pascal
+{
+    // Row n of the triangle has n + 1 entries and starts n(n+1)/2 entries into the buffer
+    constexpr size_t row_offset(size_t row)
+    {
+        return row * (row + 1) / 2;
+    }
+
+    // Anything we can walk row by row, such as a vector of vectors or a PascalTriangle
+    template<typename T>
+    concept Triangle = std::ranges::forward_range<T>
+        && std::ranges::sized_range<std::ranges::range_reference_t<T>>;
+
+    // The type of the numbers in a triangle
+    template<Triangle T>
+    using element_t = std::remove_cvref_t<
+        std::ranges::range_value_t<std::ranges::range_reference_t<T>>>;
+
+    // Rows from up to to, in a flat buffer, given the row before from.
+    // constexpr, so compile time tables can use it too
+    template<typename T>
+    constexpr void fill_rows(T* data, size_t from, size_t to)
+    {
+        for (size_t row = from; row < to; ++row)
+        {
+            T* current = data + row_offset(row);
+            const T* last = current - row; // the previous row starts row entries earlier
+            current[0] = 1;
+            for (size_t idx = 1; idx < row; ++idx)
+            {
+                current[idx] = last[idx - 1] + last[idx];
+            }
+            current[row] = 1;
+        }
+    }
+
+    // Stores every row in one contiguous buffer, rather than one vector per row,
+    // so we have a single allocation and neighbouring rows sit next to each other in memory
+    template<typename T = int>
+    class PascalTriangle
+    {
+    public:
+        // Walks the rows, giving a std::span for each one
+        class iterator
+        {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using value_type = std::span<const T>;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+            constexpr iterator(const T* data, size_t row) : data_(data), row_(row)
+            {
+            }
+
+            constexpr value_type operator*() const
+            {
+                return { data_ + row_offset(row_), row_ + 1 };
+            }
+            constexpr iterator& operator++()
+            {
+                ++row_;
+                return *this;
+            }
+            constexpr iterator operator++(int)
+            {
+                auto old = *this;
+                ++row_;
+                return old;
+            }
+            constexpr bool operator==(const iterator&) const = default;
+        private:
+            const T* data_ = nullptr;
+            size_t row_ = 0;
+        };
+
+        PascalTriangle() = default;
+
+        // Fills each row from the one above it, in place
+        explicit PascalTriangle(size_t rows)
+            : rows_(rows), data_(row_offset(rows))
+        {
+            pascal::fill_rows(data_.data(), 0, rows);
+        }
+
+        // Splits the rows into a block per thread, each with about the same number of entries.
+        // Each block starts from a row worked out directly with pascal_row,
+        // so it doesn't need to wait for the blocks above it.
+        PascalTriangle(size_t rows, unsigned threads)
+            : rows_(rows), data_(row_offset(rows))
+        {
+            threads = std::max(threads, 1u);
+            // the first r rows hold about r^2/2 entries, so block i starts at rows * sqrt(i / threads)
+            auto block_start = [rows, threads](unsigned block) {
+                return static_cast<size_t>(std::round(rows * std::sqrt(static_cast<double>(block) / threads)));
+            };
+            std::vector<std::jthread> workers;
+            for (unsigned block = 0; block < threads; ++block)
+            {
+                const size_t from = block_start(block);
+                const size_t to = block + 1 == threads ? rows : block_start(block + 1);
+                if (from < to)
+                {
+                    workers.emplace_back([this, from, to] {
+                        if (from > 0)
+                        {
+                            auto seed = pascal_row<T>(from);
+                            std::ranges::move(seed, data_.begin() + row_offset(from));
+                        }
+                        pascal::fill_rows(data_.data(), from > 0 ? from + 1 : 0, to);
+                    });
+                }
+            }
+        }
+
+        size_t size() const { return rows_; }
+        bool empty() const { return rows_ == 0; }
+
+        std::span<const T> operator[](size_t row) const
+        {
+            return { data_.data() + row_offset(row), row + 1 };
+        }
+        std::span<const T> front() const { return (*this)[0]; }
+        std::span<const T> back() const { return (*this)[rows_ - 1]; }
+
+        // Every entry, row after row
+        std::span<const T> data() const { return data_; }
+
+        iterator begin() const { return { data_.data(), 0 }; }
+        iterator end() const { return { data_.data(), rows_ }; }
+    private:
+        size_t rows_ = 0;
+        std::vector<T> data_;
+    };
+
+    // Produces rows one after another in a single preallocated buffer.
+    // Each row is updated in place from right to left, so an entry is still
+    // the old value when the entry to its right needs it.
+    // Only the latest row is kept: each span is valid until the next increment.
+    template<typename T = int>
+    class RowGenerator
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = std::span<const T>;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+            explicit iterator(RowGenerator* generator) : generator_(generator)
+            {
+            }
+
+            value_type operator*() const
+            {
+                return { generator_->buffer_.data(), generator_->row_ + 1 };
+            }
+            iterator& operator++()
+            {
+                generator_->next_row();
+                return *this;
+            }
+            void operator++(int)
+            {
+                ++*this;
+            }
+            bool operator==(std::default_sentinel_t) const
+            {
+                return generator_->row_ >= generator_->rows_;
+            }
+        private:
+            RowGenerator* generator_ = nullptr;
+        };
+
+        explicit RowGenerator(size_t rows)
+            : rows_(rows), buffer_(rows)
+        {
+        }
+
+        // Starts again from the first row
+        iterator begin()
+        {
+            std::ranges::fill(buffer_, T{});
+            row_ = 0;
+            if (rows_)
+            {
+                buffer_[0] = 1;
+            }
+            return iterator{ this };
+        }
+        std::default_sentinel_t end() const { return {}; }
+
+        size_t size() const { return rows_; }
+    private:
+        void next_row()
+        {
+            ++row_;
+            if (row_ >= rows_)
+            {
+                return;
+            }
+            for (size_t idx = row_ - 1; idx > 0; --idx)
+            {
+                buffer_[idx] += buffer_[idx - 1];
+            }
+            buffer_[row_] = 1;
+        }
+
+        size_t rows_;
+        size_t row_ = 0;
+        std::vector<T> buffer_;
+    };
+
+    // Streams the first count rows, without storing the whole triangle
+    template<typename T = int>
+    RowGenerator<T> rows(size_t count)
+    {
+        return RowGenerator<T>(count);
+    }
+
+    // Just row n (counting from zero), using O(n) memory
+    template<typename T = int>
+    std::vector<T> nth_row(size_t n)
+    {
+        auto generator = rows<T>(n + 1);
+        auto current = generator.begin();
+        for (size_t row = 0; row < n; ++row)
+        {
+            ++current;
+        }
+        return { (*current).begin(), (*current).end() };
+    }
+
+    // How many rows fit in T, along with the totals check_properties works out:
+    // 2^n for row n, then doubled once more after the last row, so up to 2^rows
+    template<typename T>
+    constexpr size_t max_rows()
+    {
+        if constexpr (std::is_same_v<T, BigUnsigned>)
+        {
+            return std::numeric_limits<size_t>::max();
+        }
+        else
+        {
+            T total = 1;
+            size_t rows = 0;
+            while (checked_add(total, total, total))
+            {
+                ++rows;
+            }
+            return rows;
+        }
+    }
+
+    // Use int while it's big enough, then switch to a wider type
+    using AnyTriangle = std::variant<PascalTriangle<int>,
+        PascalTriangle<UInt128>,
+        PascalTriangle<BigUnsigned>>;
+
+    inline AnyTriangle generate_wide_enough(size_t rows)
+    {
+        if (rows <= max_rows<int>())
+        {
+            return PascalTriangle<int>(rows);
+        }
+        if (rows <= max_rows<UInt128>())
+        {
+            return PascalTriangle<UInt128>(rows);
+        }
+        return PascalTriangle<BigUnsigned>(rows);
+    }
+
+    // Left justified, like the operator << for a vector of vectors
+    template<typename T>
+    std::ostream& operator << (std::ostream& s, const PascalTriangle<T>& triangle)
+    {
+        for (auto row : triangle)
+        {
+            std::ranges::copy(row, std::ostream_iterator<T>(s, " "));
+            s << '\n';
+        }
+        return s;
+    }
+}
@@ -0,0 +1,159 @@
+#include <cassert>
+#include <cstdint>
+
+#include "row_kernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PASCAL_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// gcc and clang need to be told a function may use AVX2 instructions, MSVC doesn't
+#if defined(PASCAL_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PASCAL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PASCAL_TARGET_AVX2
+#endif
+
+namespace
+{
+    // Each entry in next_row, apart from the ends, is last_row[idx - 1] + last_row[idx],
+    // so the vector versions load from last_row twice, one entry apart, and add
+    void add_adjacent_scalar(const int* last_row, int* next_row, size_t from, size_t to)
+    {
+        for (size_t idx = from; idx < to; ++idx)
+        {
+            // add as unsigned, so overflow wraps like the vector versions
+            next_row[idx] = static_cast<int>(static_cast<uint32_t>(last_row[idx - 1])
+                + static_cast<uint32_t>(last_row[idx]));
+        }
+    }
+
+#ifdef PASCAL_X86
+    size_t add_adjacent_sse2(const int* last_row, int* next_row, size_t from, size_t to)
+    {
+        size_t idx = from;
+        for (; idx + 4 <= to; idx += 4)
+        {
+            __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i*>(last_row + idx - 1));
+            __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i*>(last_row + idx));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(next_row + idx), _mm_add_epi32(left, right));
+        }
+        return idx;
+    }
+
+    PASCAL_TARGET_AVX2
+    size_t add_adjacent_avx2(const int* last_row, int* next_row, size_t from, size_t to)
+    {
+        size_t idx = from;
+        for (; idx + 8 <= to; idx += 8)
+        {
+            __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(last_row + idx - 1));
+            __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(last_row + idx));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(next_row + idx), _mm256_add_epi32(left, right));
+        }
+        return idx;
+    }
+
+    bool cpu_has_avx2()
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4]{};
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return false;
+        }
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) // the OS must save the ymm registers
+        {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+}
+
+namespace pascal
+{
+    std::string to_string(Kernel kernel)
+    {
+        switch (kernel)
+        {
+        case Kernel::Scalar:
+            return "scalar";
+        case Kernel::SSE2:
+            return "SSE2";
+        case Kernel::AVX2:
+            return "AVX2";
+        default:
+            return "?";
+        }
+    }
+
+    bool kernel_supported(Kernel kernel)
+    {
+#ifdef PASCAL_X86
+        static const bool has_avx2 = cpu_has_avx2();
+        switch (kernel)
+        {
+        case Kernel::Scalar:
+        case Kernel::SSE2:
+            return true;
+        case Kernel::AVX2:
+            return has_avx2;
+        }
+        return false;
+#else
+        return kernel == Kernel::Scalar;
+#endif
+    }
+
+    Kernel best_kernel()
+    {
+        static const Kernel best = kernel_supported(Kernel::AVX2) ? Kernel::AVX2
+            : kernel_supported(Kernel::SSE2) ? Kernel::SSE2
+            : Kernel::Scalar;
+        return best;
+    }
+
+    void add_adjacent(std::span<const int> last_row, std::span<int> next_row, Kernel kernel)
+    {
+        assert(next_row.size() == last_row.size() + 1);
+        assert(kernel_supported(kernel));
+        const size_t last = last_row.size();
+        next_row[0] = 1;
+        if (last == 0)
+        {
+            return;
+        }
+
+        size_t done = 1;
+#ifdef PASCAL_X86
+        if (kernel == Kernel::AVX2)
+        {
+            done = add_adjacent_avx2(last_row.data(), next_row.data(), done, last);
+        }
+        if (kernel != Kernel::Scalar)
+        {
+            done = add_adjacent_sse2(last_row.data(), next_row.data(), done, last);
+        }
+#endif
+        add_adjacent_scalar(last_row.data(), next_row.data(), done, last);
+        next_row[last] = 1;
+    }
+
+    void add_adjacent(std::span<const int> last_row, std::span<int> next_row)
+    {
+        add_adjacent(last_row, next_row, best_kernel());
+    }
+}
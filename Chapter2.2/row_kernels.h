@@ -0,0 +1,28 @@
+#pragma once
+
+#include <span>
+#include <string>
+
+namespace pascal
+{
+    // Ways to add adjacent pairs in a row, fastest last
+    enum class Kernel
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    std::string to_string(Kernel kernel);
+
+    // Checked at runtime, so one build runs on any x86 machine
+    bool kernel_supported(Kernel kernel);
+    Kernel best_kernel();
+
+    // Fills next_row, which must be one bigger than last_row, with the next row of the triangle:
+    // 1, then the sum of each adjacent pair in last_row, then 1.
+    // The pairs wrap on overflow rather than being undefined behaviour, so use this for
+    // speed, not for rows with numbers too big for int.
+    void add_adjacent(std::span<const int> last_row, std::span<int> next_row, Kernel kernel);
+    void add_adjacent(std::span<const int> last_row, std::span<int> next_row);
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace pascal
+{
+    // What a RowValidator found wrong with a row
+    enum class RowProblem
+    {
+        None,
+        WrongLength,
+        EndNotOne,
+        WrongTotal,
+        NotSymmetric,
+        Negative
+    };
+
+    inline std::string to_string(RowProblem problem)
+    {
+        switch (problem)
+        {
+        case RowProblem::None:
+            return "none";
+        case RowProblem::WrongLength:
+            return "wrong length";
+        case RowProblem::EndNotOne:
+            return "doesn't start and end with 1";
+        case RowProblem::WrongTotal:
+            return "total isn't a power of two";
+        case RowProblem::NotSymmetric:
+            return "not symmetric";
+        case RowProblem::Negative:
+            return "negative number";
+        default:
+            return "?";
+        }
+    }
+
+    // Checks the same properties as check_properties, a row at a time,
+    // so a generator can push rows into it without the triangle being kept.
+    // The total, symmetry and sign checks share one pass over each row.
+    // Use an element type wide enough for the row totals, see max_rows.
+    template<typename T = int>
+    class RowValidator
+    {
+    public:
+        using Problem = RowProblem;
+
+        // Returns false if this row, or any before it, was bad
+        bool push(std::span<const T> row)
+        {
+            if (problem_ != Problem::None)
+            {
+                return false;
+            }
+            if (rows_checked_ > 0)
+            {
+                expected_total_ += expected_total_;
+            }
+            problem_ = check(row);
+            if (problem_ != Problem::None)
+            {
+                return false;
+            }
+            ++rows_checked_;
+            return true;
+        }
+
+        bool ok() const { return problem_ == Problem::None; }
+        Problem problem() const { return problem_; }
+
+        // Rows pushed and found to be fine
+        size_t rows_checked() const { return rows_checked_; }
+
+        // Counting from zero
+        std::optional<size_t> first_bad_row() const
+        {
+            if (ok())
+            {
+                return {};
+            }
+            return rows_checked_;
+        }
+    private:
+        Problem check(std::span<const T> row) const
+        {
+            const size_t size = row.size();
+            if (size != rows_checked_ + 1)
+            {
+                return Problem::WrongLength;
+            }
+            if (row.front() != T{ 1 } || row.back() != T{ 1 })
+            {
+                return Problem::EndNotOne;
+            }
+            T total{};
+            for (size_t idx = 0; idx < size; ++idx)
+            {
+                if constexpr (std::signed_integral<T>)
+                {
+                    if (row[idx] < 0)
+                    {
+                        return Problem::Negative;
+                    }
+                }
+                if (idx < size / 2 && row[idx] != row[size - 1 - idx])
+                {
+                    return Problem::NotSymmetric;
+                }
+                total += row[idx];
+            }
+            return total == expected_total_ ? Problem::None : Problem::WrongTotal;
+        }
+
+        size_t rows_checked_ = 0;
+        T expected_total_ = 1;
+        Problem problem_ = Problem::None;
+    };
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace pascal
+{
+    // Rows of Pascal's triangle mod 2, which make the Sierpinski triangle.
+    // Bit k of the words says if entry k of the current row is odd.
+    // Each entry of the next row is the sum of the two above it,
+    // and adding mod 2 is exclusive or, so the next row is row ^ (row << 1).
+    class ParityRows
+    {
+    public:
+        // Room for the first rows rows, starting with row 0, which is just 1
+        explicit ParityRows(size_t rows)
+            : words_((rows + 63) / 64 + 1)
+        {
+            words_[0] = 1;
+        }
+
+        size_t row() const { return row_; }
+        size_t size() const { return row_ + 1; }
+
+        bool odd(size_t k) const
+        {
+            return (words_[k / 64] >> (k % 64)) & 1;
+        }
+
+        // Only the words holding the current row, lowest entries first
+        std::span<const uint64_t> words() const
+        {
+            return { words_.data(), row_ / 64 + 1 };
+        }
+
+        void next()
+        {
+            ++row_;
+            uint64_t carry = 0;
+            for (size_t idx = 0, stop = row_ / 64 + 1; idx < stop; ++idx)
+            {
+                const uint64_t word = words_[idx];
+                words_[idx] = word ^ ((word << 1) | carry);
+                carry = word >> 63;
+            }
+        }
+    private:
+        size_t row_ = 0;
+        std::vector<uint64_t> words_;
+    };
+
+    // The same output as show_view, but the numbers are never made,
+    // so this works for far more rows, using O(rows/64) memory
+    inline void show_parity(std::ostream& s, size_t rows)
+    {
+        ParityRows parity(rows);
+        std::string line;
+        for (size_t row = 0; row < rows; ++row)
+        {
+            line.assign(rows > row + 1 ? rows - row : 1, ' ');
+            for (size_t k = 0; k <= row; ++k)
+            {
+                line += parity.odd(k) ? '*' : ' ';
+                line += ' ';
+            }
+            line += '\n';
+            s.write(line.data(), static_cast<std::streamsize>(line.size()));
+            parity.next();
+        }
+    }
+
+    // A binary (P4) PBM image, one pixel per entry, black for odd numbers.
+    // Open the stream in binary mode.
+    inline void write_pbm(std::ostream& s, size_t rows)
+    {
+        // PBM wants the leftmost pixel in the top bit of a byte, but our rows start at the bottom bit
+        constexpr auto reversed = [] {
+            std::array<uint8_t, 256> table{};
+            for (unsigned byte = 0; byte < 256; ++byte)
+            {
+                for (unsigned bit = 0; bit < 8; ++bit)
+                {
+                    if (byte & (1u << bit))
+                    {
+                        table[byte] |= static_cast<uint8_t>(0x80u >> bit);
+                    }
+                }
+            }
+            return table;
+        }();
+
+        s << "P4\n" << rows << ' ' << rows << '\n';
+        ParityRows parity(rows);
+        std::vector<char> line((rows + 7) / 8);
+        for (size_t row = 0; row < rows; ++row)
+        {
+            std::ranges::fill(line, 0);
+            auto words = parity.words();
+            for (size_t byte = 0, stop = (row + 8) / 8; byte < stop; ++byte)
+            {
+                const uint8_t bits = static_cast<uint8_t>(words[byte / 8] >> (8 * (byte % 8)));
+                line[byte] = static_cast<char>(reversed[bits]);
+            }
+            s.write(line.data(), static_cast<std::streamsize>(line.size()));
+            parity.next();
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <ranges>
+#include <span>
+
+#include "pascal_triangle.h"
+#include "wide_integers.h"
+
+namespace pascal
+{
+    // N rows worked out at compile time, in a std::array laid out like a PascalTriangle,
+    // so a lookup table costs nothing at runtime
+    template<size_t N, typename T = int>
+    class TriangleTable
+    {
+    public:
+        using iterator = typename PascalTriangle<T>::iterator;
+
+        constexpr TriangleTable()
+        {
+            fill_rows(data_.data(), 0, N);
+        }
+
+        static constexpr size_t size() { return N; }
+        static constexpr bool empty() { return N == 0; }
+
+        constexpr std::span<const T> operator[](size_t row) const
+        {
+            return { data_.data() + row_offset(row), row + 1 };
+        }
+        constexpr std::span<const T> front() const { return (*this)[0]; }
+        constexpr std::span<const T> back() const { return (*this)[N - 1]; }
+
+        constexpr std::span<const T> data() const { return data_; }
+
+        constexpr iterator begin() const { return { data_.data(), 0 }; }
+        constexpr iterator end() const { return { data_.data(), N }; }
+    private:
+        std::array<T, row_offset(N)> data_{};
+    };
+
+    template<size_t N, typename T = int>
+    inline constexpr TriangleTable<N, T> triangle_table{};
+
+    // The properties check_properties asserts at runtime, as constant expressions
+    template<size_t N, typename T>
+    constexpr bool rows_total_powers_of_two(const TriangleTable<N, T>& table)
+    {
+        T expected_total = 1;
+        for (auto row : table)
+        {
+            T total{};
+            for (const auto& data : row)
+            {
+                total += data;
+            }
+            if (total != expected_total)
+            {
+                return false;
+            }
+            expected_total += expected_total;
+        }
+        return true;
+    }
+
+    template<size_t N, typename T>
+    constexpr bool rows_symmetric(const TriangleTable<N, T>& table)
+    {
+        return std::ranges::all_of(table, [](auto row) {
+            return std::ranges::equal(row, row | std::views::reverse);
+        });
+    }
+
+    template<size_t N, typename T>
+    constexpr bool rows_start_and_end_with_one(const TriangleTable<N, T>& table)
+    {
+        return std::ranges::all_of(table, [](auto row) {
+            return row.front() == T{ 1 } && row.back() == T{ 1 };
+        });
+    }
+
+    template<size_t N, typename T>
+    constexpr bool no_negatives(const TriangleTable<N, T>& table)
+    {
+        if constexpr (std::signed_integral<T>)
+        {
+            return std::ranges::none_of(table.data(), [](T x) { return x < 0; });
+        }
+        return true;
+    }
+
+    // As many rows as fit, for int and UInt128.
+    // The UInt128 table is a big constant evaluation, so the project raises MSVC's /constexpr:steps.
+    static_assert(rows_total_powers_of_two(triangle_table<max_rows<int>()>));
+    static_assert(rows_symmetric(triangle_table<max_rows<int>()>));
+    static_assert(rows_start_and_end_with_one(triangle_table<max_rows<int>()>));
+    static_assert(no_negatives(triangle_table<max_rows<int>()>));
+    static_assert(triangle_table<16>[15][7] == 6435);
+
+    static_assert(rows_total_powers_of_two(triangle_table<max_rows<UInt128>(), UInt128>));
+    static_assert(rows_symmetric(triangle_table<max_rows<UInt128>(), UInt128>));
+    static_assert(rows_start_and_end_with_one(triangle_table<max_rows<UInt128>(), UInt128>));
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "pascal_triangle.h"
+
+namespace pascal
+{
+    // Centre justified output, like show_vectors_more_general, byte for byte.
+    // Everything is formatted into one buffer, kept between calls, then sent with a single write,
+    // rather than calling std::format for every number.
+    class TriangleWriter
+    {
+    public:
+        // Enough room for the biggest number, in the last row, and a space either side,
+        // as main works out for show_vectors_more_general
+        static size_t width_needed(const Triangle auto& v)
+        {
+            size_t digits = 1;
+            for (const auto& data : v.back())
+            {
+                digits = std::max(digits, number_length(data));
+            }
+            return digits + 2;
+        }
+
+        // A width of 6 matches show_vectors
+        void write(std::ostream& s, const Triangle auto& v, size_t width = 6)
+        {
+            buffer_.clear();
+            const size_t gaps = width / 2;
+            size_t spaces = v.back().size() * gaps;
+            for (const auto& row : v)
+            {
+                buffer_.append(spaces, ' ');
+                if (spaces > gaps)
+                {
+                    spaces -= gaps;
+                }
+                for (const auto& data : row)
+                {
+                    append_centred(data, width);
+                }
+                buffer_ += '\n';
+            }
+            s.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        }
+    private:
+        template<typename T>
+        static size_t number_length(const T& data)
+        {
+            if constexpr (std::integral<T>)
+            {
+                char digits[24];
+                return static_cast<size_t>(std::to_chars(std::begin(digits), std::end(digits), data).ptr - digits);
+            }
+            else
+            {
+                return to_string(data).size();
+            }
+        }
+
+        // Like std::format("{: ^{}}", data, width): any odd space goes after the number
+        template<typename T>
+        void append_centred(const T& data, size_t width)
+        {
+            char digits[24];
+            std::string_view text;
+            std::string long_text;
+            if constexpr (std::integral<T>)
+            {
+                text = { digits, std::to_chars(std::begin(digits), std::end(digits), data).ptr };
+            }
+            else
+            {
+                long_text = to_string(data);
+                text = long_text;
+            }
+            const size_t padding = width > text.size() ? width - text.size() : 0;
+            buffer_.append(padding / 2, ' ');
+            buffer_ += text;
+            buffer_.append(padding - padding / 2, ' ');
+        }
+
+        std::string buffer_;
+    };
+}
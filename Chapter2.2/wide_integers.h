@@ -0,0 +1,342 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pascal
+{
+    // Adds without overflowing: returns false, leaving result alone, if a + b doesn't fit
+    template<std::integral T>
+    constexpr bool checked_add(T a, T b, T& result)
+    {
+        if ((b > 0 && a > std::numeric_limits<T>::max() - b)
+            || (b < 0 && a < std::numeric_limits<T>::min() - b))
+        {
+            return false;
+        }
+        result = a + b;
+        return true;
+    }
+
+    namespace detail
+    {
+        // The full 128-bit product, from four 32-bit by 32-bit products
+        constexpr void multiply_wide(uint64_t a, uint64_t b, uint64_t& high, uint64_t& low)
+        {
+            const uint64_t low_low = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+            const uint64_t low_high = (a & 0xFFFFFFFF) * (b >> 32);
+            const uint64_t high_low = (a >> 32) * (b & 0xFFFFFFFF);
+            const uint64_t middle = (low_low >> 32) + (low_high & 0xFFFFFFFF) + (high_low & 0xFFFFFFFF);
+            low = (middle << 32) | (low_low & 0xFFFFFFFF);
+            high = (a >> 32) * (b >> 32) + (low_high >> 32) + (high_low >> 32) + (middle >> 32);
+        }
+
+        // Long division of 32-bit chunks, most significant first, by a divisor below 2^32.
+        // The chunks are replaced by the quotient, and the remainder returned.
+        constexpr uint32_t divide_chunks(uint32_t* chunks, size_t count, uint32_t divisor)
+        {
+            uint64_t remainder = 0;
+            for (size_t idx = 0; idx < count; ++idx)
+            {
+                uint64_t current = (remainder << 32) | chunks[idx];
+                chunks[idx] = static_cast<uint32_t>(current / divisor);
+                remainder = current % divisor;
+            }
+            return static_cast<uint32_t>(remainder);
+        }
+
+        // Decimal digits of the number held in the chunks, most significant first
+        inline std::string chunks_to_string(std::vector<uint32_t> chunks)
+        {
+            constexpr uint32_t billion = 1'000'000'000;
+            std::vector<uint32_t> groups; // nine decimal digits each, least significant first
+            while (std::ranges::any_of(chunks, [](uint32_t x) { return x != 0; }))
+            {
+                groups.push_back(divide_chunks(chunks.data(), chunks.size(), billion));
+            }
+            if (groups.empty())
+            {
+                return "0";
+            }
+            std::string digits = std::to_string(groups.back());
+            for (auto group = groups.rbegin() + 1; group != groups.rend(); ++group)
+            {
+                auto next = std::to_string(*group);
+                digits += std::string(9 - next.size(), '0') + next;
+            }
+            return digits;
+        }
+    }
+
+    // A fixed width 128-bit unsigned number, for triangles with up to 128 rows
+    class UInt128
+    {
+    public:
+        constexpr UInt128() = default;
+        constexpr UInt128(uint64_t value) : low_(value)
+        {
+        }
+        constexpr UInt128(uint64_t high, uint64_t low) : low_(low), high_(high)
+        {
+        }
+
+        constexpr uint64_t low() const { return low_; }
+        constexpr uint64_t high() const { return high_; }
+
+        constexpr UInt128& operator+=(const UInt128& other)
+        {
+            const uint64_t low = low_ + other.low_; // other may be *this
+            high_ += other.high_ + (low < low_ ? 1 : 0);
+            low_ = low;
+            return *this;
+        }
+        friend constexpr UInt128 operator+(UInt128 lhs, const UInt128& rhs)
+        {
+            return lhs += rhs;
+        }
+
+        // Wraps on overflow, like built-in unsigned types
+        constexpr UInt128& operator*=(uint64_t factor)
+        {
+            uint64_t carry = 0;
+            detail::multiply_wide(low_, factor, carry, low_);
+            high_ = high_ * factor + carry;
+            return *this;
+        }
+        // Divides a 32-bit chunk at a time, like BigUnsigned
+        constexpr UInt128& operator/=(uint32_t divisor)
+        {
+            divide(divisor);
+            return *this;
+        }
+        // Divides, giving back the remainder
+        constexpr uint32_t divide(uint32_t divisor)
+        {
+            auto parts = chunks();
+            const uint32_t remainder = detail::divide_chunks(parts.data(), parts.size(), divisor);
+            *this = from_chunks(parts);
+            return remainder;
+        }
+
+        friend constexpr bool operator==(const UInt128&, const UInt128&) = default;
+        friend constexpr std::strong_ordering operator<=>(const UInt128& lhs, const UInt128& rhs)
+        {
+            if (auto order = lhs.high_ <=> rhs.high_; order != 0)
+            {
+                return order;
+            }
+            return lhs.low_ <=> rhs.low_;
+        }
+
+        friend constexpr bool checked_add(const UInt128& a, const UInt128& b, UInt128& result)
+        {
+            UInt128 sum = a + b;
+            if (sum < a)
+            {
+                return false;
+            }
+            result = sum;
+            return true;
+        }
+
+        friend std::string to_string(const UInt128& value)
+        {
+            auto parts = value.chunks();
+            return detail::chunks_to_string({ parts.begin(), parts.end() });
+        }
+        friend std::ostream& operator<<(std::ostream& s, const UInt128& value)
+        {
+            return s << to_string(value);
+        }
+    private:
+        // Most significant first
+        constexpr std::array<uint32_t, 4> chunks() const
+        {
+            return { static_cast<uint32_t>(high_ >> 32), static_cast<uint32_t>(high_),
+                static_cast<uint32_t>(low_ >> 32), static_cast<uint32_t>(low_) };
+        }
+        static constexpr UInt128 from_chunks(const std::array<uint32_t, 4>& parts)
+        {
+            return { (uint64_t{ parts[0] } << 32) | parts[1], (uint64_t{ parts[2] } << 32) | parts[3] };
+        }
+
+        uint64_t low_ = 0;
+        uint64_t high_ = 0;
+    };
+
+    // An unsigned number of any size, held as 64-bit limbs, least significant first.
+    // Zero has no limbs, and there are never leading zero limbs.
+    class BigUnsigned
+    {
+    public:
+        BigUnsigned() = default;
+        BigUnsigned(uint64_t value)
+        {
+            if (value)
+            {
+                limbs_.push_back(value);
+            }
+        }
+
+        const std::vector<uint64_t>& limbs() const { return limbs_; }
+
+        // Adds a block of limbs at a time.
+        // The first loop over a block has no dependency between limbs, so it vectorises,
+        // leaving the carries to ripple through in a second, cheap, loop.
+        BigUnsigned& operator+=(const BigUnsigned& other)
+        {
+            constexpr size_t block = 8;
+            const size_t count = other.limbs_.size();
+            if (limbs_.size() < count)
+            {
+                limbs_.resize(count);
+            }
+            uint64_t carry = 0;
+            for (size_t start = 0; start < count; start += block)
+            {
+                const size_t stop = std::min(count, start + block);
+                std::array<uint64_t, block> wrapped{};
+                for (size_t idx = start; idx < stop; ++idx)
+                {
+                    uint64_t sum = limbs_[idx] + other.limbs_[idx];
+                    wrapped[idx - start] = sum < limbs_[idx];
+                    limbs_[idx] = sum;
+                }
+                for (size_t idx = start; idx < stop; ++idx)
+                {
+                    // if the limb wrapped it is at most 2^64 - 2, so adding the carry can't wrap too
+                    uint64_t sum = limbs_[idx] + carry;
+                    carry = wrapped[idx - start] | (sum < carry);
+                    limbs_[idx] = sum;
+                }
+            }
+            for (size_t idx = count; carry && idx < limbs_.size(); ++idx)
+            {
+                carry = ++limbs_[idx] == 0;
+            }
+            if (carry)
+            {
+                limbs_.push_back(1);
+            }
+            return *this;
+        }
+        friend BigUnsigned operator+(BigUnsigned lhs, const BigUnsigned& rhs)
+        {
+            return lhs += rhs;
+        }
+
+        BigUnsigned& operator*=(uint64_t factor)
+        {
+            uint64_t carry = 0;
+            for (auto& limb : limbs_)
+            {
+                uint64_t high = 0;
+                detail::multiply_wide(limb, factor, high, limb);
+                limb += carry;
+                carry = high + (limb < carry); // high is at most 2^64 - 2, so this can't wrap
+            }
+            if (carry)
+            {
+                limbs_.push_back(carry);
+            }
+            trim();
+            return *this;
+        }
+
+        // Dividing by a 32-bit number works a half limb at a time,
+        // so every intermediate fits in 64 bits
+
+        // Rounds down, like dividing built-in unsigned types
+        BigUnsigned& operator/=(uint32_t divisor)
+        {
+            divide(divisor);
+            return *this;
+        }
+        // Divides, giving back the remainder
+        uint32_t divide(uint32_t divisor)
+        {
+            uint64_t remainder = 0;
+            for (auto limb = limbs_.rbegin(); limb != limbs_.rend(); ++limb)
+            {
+                uint64_t high = (remainder << 32) | (*limb >> 32);
+                remainder = high % divisor;
+                uint64_t low = (remainder << 32) | (*limb & 0xFFFFFFFF);
+                remainder = low % divisor;
+                *limb = ((high / divisor) << 32) | (low / divisor);
+            }
+            trim();
+            return static_cast<uint32_t>(remainder);
+        }
+
+        friend bool operator==(const BigUnsigned&, const BigUnsigned&) = default;
+        friend std::strong_ordering operator<=>(const BigUnsigned& lhs, const BigUnsigned& rhs)
+        {
+            if (auto order = lhs.limbs_.size() <=> rhs.limbs_.size(); order != 0)
+            {
+                return order;
+            }
+            return std::lexicographical_compare_three_way(lhs.limbs_.rbegin(), lhs.limbs_.rend(),
+                rhs.limbs_.rbegin(), rhs.limbs_.rend());
+        }
+
+        // Never overflows
+        friend bool checked_add(const BigUnsigned& a, const BigUnsigned& b, BigUnsigned& result)
+        {
+            result = a + b;
+            return true;
+        }
+
+        friend std::string to_string(const BigUnsigned& value)
+        {
+            std::vector<uint32_t> chunks;
+            for (auto limb = value.limbs_.rbegin(); limb != value.limbs_.rend(); ++limb)
+            {
+                chunks.push_back(static_cast<uint32_t>(*limb >> 32));
+                chunks.push_back(static_cast<uint32_t>(*limb));
+            }
+            return detail::chunks_to_string(std::move(chunks));
+        }
+        friend std::ostream& operator<<(std::ostream& s, const BigUnsigned& value)
+        {
+            return s << to_string(value);
+        }
+    private:
+        void trim()
+        {
+            while (!limbs_.empty() && limbs_.back() == 0)
+            {
+                limbs_.pop_back();
+            }
+        }
+
+        std::vector<uint64_t> limbs_;
+    };
+}
+
+// So std::format("{: ^{}}", ...) centres these like any other number
+template<>
+struct std::formatter<pascal::UInt128> : std::formatter<std::string>
+{
+    auto format(const pascal::UInt128& value, std::format_context& ctx) const
+    {
+        return std::formatter<std::string>::format(to_string(value), ctx);
+    }
+};
+
+template<>
+struct std::formatter<pascal::BigUnsigned> : std::formatter<std::string>
+{
+    auto format(const pascal::BigUnsigned& value, std::format_context& ctx) const
+    {
+        return std::formatter<std::string>::format(to_string(value), ctx);
+    }
+};
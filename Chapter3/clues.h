@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "digits.h"
+#include "prime_table.h"
+
+namespace clues
+{
+	// Gives the clue for a guess, or an empty string_view if it has nothing to say
+	template<typename T>
+	concept Check = std::invocable<T&, int>
+		&& std::convertible_to<std::invoke_result_t<T&, int>, std::string_view>;
+
+	// The checks from Listing 3.20, held in a tuple rather than a vector of std::function,
+	// so each call is direct and can be inlined, and no clue allocates a std::string
+	template<Check... Checks>
+	class ClueChain
+	{
+	public:
+		explicit ClueChain(Checks... checks) : checks_(std::move(checks)...)
+		{
+		}
+
+		// The first non-empty clue; the checks after it aren't called
+		std::string_view operator()(int guess)
+		{
+			std::string_view clue;
+			std::apply([&clue, guess](auto&... check) {
+				((clue = check(guess), !clue.empty()) || ...);
+			}, checks_);
+			return clue;
+		}
+	private:
+		std::tuple<Checks...> checks_;
+	};
+
+	inline std::string_view check_length(int guess)
+	{
+		return guess < 100000 ? "" : "Too long\n";
+	}
+
+	inline std::string_view check_prime(int guess)
+	{
+		return primes::is_prime_lookup(guess) ? "" : "Not prime\n";
+	}
+
+	// The clue is written into a buffer inside the check, so is only valid until the next call
+	class CheckDigits
+	{
+	public:
+		explicit CheckDigits(unsigned number) : number_(number)
+		{
+		}
+
+		std::string_view operator()(int guess)
+		{
+			digits::check_which_digits_correct(number_, static_cast<unsigned>(guess), std::span(clue_).first(5));
+			clue_[5] = '\n';
+			return { clue_.data(), clue_.size() };
+		}
+	private:
+		unsigned number_;
+		std::array<char, 6> clue_{};
+	};
+}
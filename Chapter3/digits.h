@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace digits
+{
+	// Enough for any 32-bit unsigned number
+	constexpr size_t max_digits = 10;
+
+	// The digits of n, most significant first, padded with leading zeros to fill out,
+	// like std::format("{:0>5}", n) for five digits. n must fit in out.size() digits.
+	constexpr void to_digits(unsigned n, std::span<uint8_t> out)
+	{
+		for (auto digit = out.rbegin(); digit != out.rend(); ++digit)
+		{
+			*digit = static_cast<uint8_t>(n % 10);
+			n /= 10;
+		}
+		assert(n == 0);
+	}
+
+	// Listing 3.14 without allocating: the width is matches.size(), up to max_digits.
+	// * means correct in the right place
+	// ^ means correct in the wrong place
+	// . means wrong
+	// Instead of searching for each digit, count how many of each digit of number are left
+	// once the exact matches are taken out, then hand those out to the guess from left to right.
+	constexpr void check_which_digits_correct(unsigned number, unsigned guess, std::span<char> matches)
+	{
+		assert(matches.size() <= max_digits);
+		std::array<uint8_t, max_digits> number_digits{};
+		std::array<uint8_t, max_digits> guess_digits{};
+		const auto width = matches.size();
+		to_digits(number, std::span(number_digits).first(width));
+		to_digits(guess, std::span(guess_digits).first(width));
+
+		std::array<uint8_t, 10> unmatched{};
+		for (size_t i = 0; i < width; ++i)
+		{
+			if (guess_digits[i] == number_digits[i])
+			{
+				matches[i] = '*';
+			}
+			else
+			{
+				matches[i] = '.';
+				++unmatched[number_digits[i]];
+			}
+		}
+		for (size_t i = 0; i < width; ++i)
+		{
+			if (matches[i] == '.' && unmatched[guess_digits[i]])
+			{
+				matches[i] = '^';
+				--unmatched[guess_digits[i]];
+			}
+		}
+	}
+
+	template<size_t Digits = 5>
+	constexpr std::array<char, Digits> which_digits_correct(unsigned number, unsigned guess)
+	{
+		std::array<char, Digits> matches{};
+		check_which_digits_correct(number, guess, matches);
+		return matches;
+	}
+
+	template<size_t Digits>
+	constexpr std::string_view as_string_view(const std::array<char, Digits>& matches)
+	{
+		return { matches.data(), Digits };
+	}
+
+	static_assert(as_string_view(which_digits_correct(78737, 87739)) == "^^**.");
+	static_assert(as_string_view(which_digits_correct<7>(1234567, 7654321)) == "^^^*^^^");
+}
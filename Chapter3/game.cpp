@@ -0,0 +1,33 @@
+#include <format>
+
+#include "game.h"
+
+namespace game
+{
+	Session::Session(unsigned number)
+		: number_(number), clues_(clues::check_length, clues::check_prime, clues::CheckDigits{ number })
+	{
+	}
+
+	Response Session::step(std::optional<unsigned> guess)
+	{
+		if (state_ != State::Playing)
+		{
+			return { state_, "The game is over.\n" };
+		}
+		if (!guess)
+		{
+			state_ = State::GaveUp;
+			return { state_, std::format("The number was {:0>5}\n", number_) };
+		}
+		++guesses_;
+		if (guess.value() == number_)
+		{
+			state_ = State::Won;
+			return { state_, "Well done.\n" };
+		}
+		auto text = std::format("{:0>5} is wrong. Try again\n", guess.value());
+		text += clues_(static_cast<int>(guess.value()));
+		return { state_, std::move(text) };
+	}
+}
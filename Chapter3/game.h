@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "clues.h"
+
+namespace game
+{
+	enum class State
+	{
+		Playing,
+		Won,
+		GaveUp
+	};
+
+	struct Response
+	{
+		State state;
+		std::string text;
+	};
+
+	// The game from Listing 3.19, without its loop or std::cin:
+	// whoever holds the session feeds it one guess at a time, so it can be put down
+	// between guesses and many can be played at once
+	class Session
+	{
+	public:
+		explicit Session(unsigned number);
+
+		// What the game says when it starts
+		static std::string_view greeting() { return "Guess the number.\n"; }
+
+		// A guess, or nothing to give up
+		Response step(std::optional<unsigned> guess);
+
+		unsigned number() const { return number_; }
+		size_t guesses() const { return guesses_; }
+		State state() const { return state_; }
+	private:
+		using Clues = clues::ClueChain<std::string_view(*)(int), std::string_view(*)(int), clues::CheckDigits>;
+
+		unsigned number_;
+		Clues clues_;
+		size_t guesses_ = 0;
+		State state_ = State::Playing;
+	};
+}
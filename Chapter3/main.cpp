@@ -1,16 +1,34 @@
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <concepts>
 #include <format>
 // if you are using fmt instead, swap the last include for the next two lines and change std::format to fmt::format
 //#define FMT_HEADER_ONLY
 //#include <fmt/core.h>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <mutex>
 #include <optional>
 #include <random>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "clues.h"
+#include "digits.h"
+#include "game.h"
+#include "number_reader.h"
+#include "prime_table.h"
+#include "primes.h"
+#include "random_engine.h"
+#include "server.h"
+#include "solver.h"
 
 // Listing 3.1
 unsigned some_const_number()
@@ -78,10 +96,9 @@ void guess_number_or_give_up(int number)
 // Listing 3.9
 unsigned some_random_number()
 {
-	std::random_device rd;
-	std::mt19937 mt(rd());
+	auto& gen = rng::engine(); // seeded once per thread, rather than every call
 	std::uniform_int_distribution<> dist(0, 100);
-	return dist(mt);
+	return dist(gen);
 }
 
 // Listing 3.11 Function to check if a number is prime
@@ -146,6 +163,65 @@ void check_properties()
 	static_assert(is_prime(7321));
 	static_assert(is_prime(56897));
 	static_assert(is_prime(41521));
+
+	// The compile time table agrees with is_prime, checked a block at a time
+	// to stay inside the compiler's limit on steps per constant expression
+	constexpr auto table_matches = [](int from, int to) {
+		for (int n = from; n < to; ++n)
+		{
+			if (primes::is_prime_lookup(n) != is_prime(n))
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+	static_assert(table_matches(0, 20000));
+	static_assert(table_matches(20000, 40000));
+	static_assert(table_matches(40000, 60000));
+	static_assert(table_matches(60000, 80000));
+	static_assert(table_matches(80000, 100000));
+
+	// Reseeding repeats the numbers, and a split hands over the next stretch of them
+	rng::Xoshiro256 first{ 42 }, second{ 42 };
+	for (int idx = 0; idx < 10; ++idx)
+	{
+		assert(first() == second());
+	}
+	second.reseed(42);
+	first.reseed(42);
+	assert(first == second && first() == second());
+	const rng::Xoshiro256 before_split = first;
+	auto split_off = first.split();
+	assert(split_off == before_split && first != before_split);
+	assert(first() != split_off());
+	// The same for this thread's engine, which is put back afterwards so the game stays random
+	const rng::Xoshiro256 saved = rng::engine();
+	rng::reseed(7);
+	const auto from_seven = rng::engine()();
+	rng::reseed(7);
+	assert(rng::engine()() == from_seven);
+	rng::engine() = saved;
+
+	// The prime index counts and finds the same primes as the sieve
+	const primes::PrimeIndex small_index{ 100000 };
+	assert(small_index.count() == 9592);
+	assert(small_index.nth(0) == 2);
+	assert(small_index.nth(9591) == 99991);
+	// Enough for a few segments, checked either side of where the first one ends
+	const auto sieved = primes::primes_below(2'000'000);
+	const primes::PrimeIndex index{ 2'000'000 };
+	assert(index.count() == sieved.size());
+	const auto boundary = std::ranges::lower_bound(sieved, 3 + 2 * primes::segment_odds) - sieved.begin();
+	for (auto i = boundary - 3; i < boundary + 3; ++i)
+	{
+		assert(index.nth(i) == sieved[i]);
+	}
+	assert(index.nth(sieved.size() - 1) == sieved.back());
+	for (int idx = 0; idx < 10; ++idx)
+	{
+		assert(primes::is_prime(index.random_prime(rng::engine())));
+	}
 	auto got = check_which_digits_correct(12347, 11779);
 	assert(got == "*.^..");
 	got = check_which_digits_correct(12345, 23451);
@@ -163,6 +239,38 @@ void check_properties()
 	got = check_which_digits_correct(number, 87739);
 	assert(got == "^^**.");
 
+	// The version without allocations gives the same clues
+	for (auto [number, guess] : { std::pair{ 12347u, 11779u }, { 12345u, 23451u }, { 12345u, 12345u },
+		{ 48533u, 12345u }, { 98041u, 41141u }, { 1723u, 17231u }, { 78737u, 87739u } })
+	{
+		auto matches = digits::which_digits_correct(number, guess);
+		assert(digits::as_string_view(matches) == check_which_digits_correct(number, guess));
+	}
+
+	// The statically dispatched clues stop at the first one with something to say
+	clues::ClueChain chain{ clues::check_length, clues::check_prime, clues::CheckDigits{ 56897 } };
+	assert(chain(123456) == "Too long\n");
+	assert(chain(56898) == "Not prime\n");
+	assert(chain(41521) == "..^..\n");
+
+	// The buffered reader gives the same numbers, and gaps, as read_number
+	const std::string script = "12 abc def\n 7\n99999999999 5\n42x\n+3 4\n+ 8\n";
+	std::istringstream stream{ script };
+	std::istringstream buffered_stream{ script };
+	reader::NumberReader buffered{ buffered_stream, 16 };
+	for (int idx = 0; idx < 12; ++idx)
+	{
+		assert(read_number(stream) == buffered.next());
+	}
+
+	// A session gives the same answers as guess_number_with_more_clues, a step at a time
+	game::Session session{ 56897 };
+	assert(session.step(123456).text == "123456 is wrong. Try again\nToo long\n");
+	assert(session.step(41521).text == "41521 is wrong. Try again\n..^..\n");
+	assert(session.step(56897).state == game::State::Won);
+	assert(session.guesses() == 3);
+	game::Session given_up{ 7321 };
+	assert(given_up.step({}).text == "The number was 07321\n");
 }
 
 // Listing 3.15 A much better number guessing game
@@ -187,23 +295,33 @@ void guess_number_with_clues(unsigned number, auto message)
 // Listing 3.12 Generating a prime number
 int some_prime_number()
 {
-	std::random_device rd;
-	std::mt19937 mt{ rd() };
+	auto& gen = rng::engine();
 	std::uniform_int_distribution<int> dist{0, 99999};
 	int n{};
 	while (!is_prime(n))
 	{
-		n = dist(mt);
+		n = dist(gen);
 	}
 	return n;
 }
 
+// Not in the text: sieve once, then pick a prime at random from the table.
+// This takes the same time every call, and never tests a composite number again.
+int some_prime_number_from_sieve()
+{
+	const auto& table = primes::table_primes();
+	auto& gen = rng::engine();
+	std::uniform_int_distribution<size_t> dist{ 0, table.size() - 1 };
+	return static_cast<int>(table[dist(gen)]);
+}
+
 // Listing 3.19 Using all the clues
-void guess_number_with_more_clues(int number, auto messages)
+// Not in the text: the guesses can come from a reader::NumberReader too
+void guess_number_with_more_clues(int number, auto messages, auto& in)
 {
 	std::cout << "Guess the number.\n>";
 	std::optional<int> guess;
-	while (guess = read_number(std::cin))
+	while (guess = read_number(in))
 	{
 		if (guess.value() == number)
 		{
@@ -211,22 +329,253 @@ void guess_number_with_more_clues(int number, auto messages)
 			return;
 		}
 		std::cout << std::format("{:0>5} is wrong. Try again\n", guess.value());
-		for (auto message : messages)
+		// A clues::ClueChain is called directly, and finds the first clue itself
+		if constexpr (std::invocable<decltype(messages)&, int>)
+		{
+			std::cout << messages(guess.value());
+		}
+		else
 		{
-			auto clue = message(guess.value());
-			if (clue.length())
+			for (auto message : messages)
 			{
-				std::cout << clue;
-				break;
+				auto clue = message(guess.value());
+				if (clue.length())
+				{
+					std::cout << clue;
+					break;
+				}
 			}
 		}
 	}
 	std::cout << std::format("The number was {:0>5}\n", (number));
 }
 
+void guess_number_with_more_clues(int number, auto messages)
+{
+	guess_number_with_more_clues(number, messages, std::cin);
+}
 
-int main()
+// Not in the text: times is_prime against trial division then Miller-Rabin,
+// checking a block of numbers starting at various sizes
+void benchmark_primality(std::ostream& s)
 {
+	using namespace std::chrono;
+	constexpr uint64_t count = 200'000;
+	for (uint64_t start : { 1'000ull, 100'000ull, 10'000'000ull, 1'000'000'000ull, 2'000'000'000ull,
+		1'000'000'000'000ull, 1'000'000'000'000'000'000ull })
+	{
+		auto before = steady_clock::now();
+		uint64_t found = 0;
+		for (uint64_t n = start; n < start + count; ++n)
+		{
+			found += primes::is_prime(n);
+		}
+		duration<double, std::nano> fast = (steady_clock::now() - before) / count;
+		s << std::format("from {:>19}: {:>5} primes, Miller-Rabin {:>8.1f}ns", start, found, fast.count());
+
+		if (start + count <= static_cast<uint64_t>(std::numeric_limits<int>::max()))
+		{
+			before = steady_clock::now();
+			uint64_t trial_found = 0;
+			for (uint64_t n = start; n < start + count; ++n)
+			{
+				trial_found += is_prime(static_cast<int>(n));
+			}
+			duration<double, std::nano> trial = (steady_clock::now() - before) / count;
+			assert(trial_found == found);
+			s << std::format(", is_prime {:>8.1f}ns", trial.count());
+		}
+		s << " per number\n";
+	}
+}
+
+// Not in the text: candidates per second, checking a stream of random numbers below 2^31
+void benchmark_batch_primality(std::ostream& s)
+{
+	using namespace std::chrono;
+	std::mt19937 mt{ 42 };
+	std::uniform_int_distribution<uint32_t> dist{ 0, static_cast<uint32_t>(std::numeric_limits<int>::max()) };
+	std::vector<uint32_t> candidates(1'000'000);
+	for (auto& candidate : candidates)
+	{
+		candidate = dist(mt);
+	}
+	auto per_second = [&candidates](duration<double> taken) {
+		return candidates.size() / taken.count() / 1e6;
+	};
+
+	auto before = steady_clock::now();
+	size_t trial_found = 0;
+	for (uint32_t candidate : candidates)
+	{
+		trial_found += is_prime(static_cast<int>(candidate));
+	}
+	const double trial = per_second(steady_clock::now() - before);
+
+	before = steady_clock::now();
+	size_t single_found = 0;
+	for (uint32_t candidate : candidates)
+	{
+		single_found += primes::is_prime(candidate);
+	}
+	const double single = per_second(steady_clock::now() - before);
+
+	before = steady_clock::now();
+	std::vector<uint8_t> results(candidates.size());
+	primes::is_prime_batch(candidates, results);
+	const double batch = per_second(steady_clock::now() - before);
+	const auto batch_found = static_cast<size_t>(std::ranges::count(results, 1));
+
+	assert(trial_found == single_found && single_found == batch_found);
+	s << std::format("{} random candidates, {} primes, millions per second: "
+		"is_prime {:.2f}, primes::is_prime {:.2f}, is_prime_batch {:.2f}\n",
+		candidates.size(), batch_found, trial, single, batch);
+}
+
+// Not in the text: lets the solver play against every prime the game could pick
+void benchmark_solver(std::ostream& s)
+{
+	using namespace std::chrono;
+	auto before = steady_clock::now();
+	solver::Solver player;
+	duration<double, std::milli> setup = steady_clock::now() - before;
+
+	const auto numbers = primes::primes_below(100000);
+	size_t total_guesses = 0;
+	size_t most_guesses = 0;
+	before = steady_clock::now();
+	for (unsigned number : numbers)
+	{
+		const size_t guesses = solver::play(player, number);
+		total_guesses += guesses;
+		most_guesses = std::max(most_guesses, guesses);
+	}
+	duration<double, std::micro> per_game = (steady_clock::now() - before) / numbers.size();
+	s << std::format("{} games: {:.3f} guesses on average, at most {}, {:.1f}us per game ({:.0f}ms setup)\n",
+		numbers.size(), static_cast<double>(total_guesses) / numbers.size(), most_guesses,
+		per_game.count(), setup.count());
+}
+
+// Not in the text: replays a million scripted guesses through read_number and the buffered reader
+void benchmark_number_reader(std::ostream& s)
+{
+	using namespace std::chrono;
+	std::mt19937 mt{ 42 };
+	std::uniform_int_distribution<unsigned> dist{ 0, 99999 };
+	std::string script;
+	for (int idx = 0; idx < 1'000'000; ++idx)
+	{
+		script += std::format("{:0>5}\n", dist(mt));
+	}
+
+	auto replay = [](auto& in) {
+		uint64_t total = 0;
+		while (auto guess = read_number(in))
+		{
+			total += guess.value();
+		}
+		return total;
+	};
+
+	std::istringstream stream{ script };
+	auto before = steady_clock::now();
+	const auto total = replay(stream);
+	duration<double, std::milli> formatted = steady_clock::now() - before;
+
+	std::istringstream buffered_stream{ script };
+	before = steady_clock::now();
+	reader::NumberReader buffered{ buffered_stream };
+	const auto buffered_total = replay(buffered);
+	duration<double, std::milli> fast = steady_clock::now() - before;
+
+	assert(total == buffered_total);
+	s << std::format("1000000 guesses: read_number {:.1f}ms, reader::NumberReader {:.1f}ms\n",
+		formatted.count(), fast.count());
+}
+
+// Not in the text: many sessions at once, each guessing wrong a few times then right,
+// a round at a time so every session is open together
+void benchmark_sessions(std::ostream& s)
+{
+	using namespace std::chrono;
+	constexpr uint64_t sessions = 20'000;
+	constexpr unsigned wrong_guesses = 5;
+	const auto numbers = primes::primes_below(100000);
+
+	auto before = steady_clock::now();
+	server::SessionServer server{ std::max(std::thread::hardware_concurrency(), 1u), [](uint64_t, const game::Response&) {}, true };
+	for (uint64_t id = 0; id < sessions; ++id)
+	{
+		server.open(id, numbers[id % numbers.size()]);
+	}
+	for (unsigned round = 0; round <= wrong_guesses; ++round)
+	{
+		for (uint64_t id = 0; id < sessions; ++id)
+		{
+			const unsigned number = numbers[id % numbers.size()];
+			server.guess(id, round < wrong_guesses ? (number + round + 1) % 100000 : number);
+		}
+	}
+	server.stop();
+	duration<double> taken = steady_clock::now() - before;
+
+	auto latencies = server.step_latencies();
+	auto p99 = latencies.begin() + latencies.size() * 99 / 100;
+	std::ranges::nth_element(latencies, p99);
+	assert(server.sessions_finished() == sessions);
+	s << std::format("{} sessions of {} steps on {} threads: {:.0f} sessions/s, p99 step latency {:.1f}us\n",
+		sessions, wrong_guesses + 2, std::max(std::thread::hardware_concurrency(), 1u),
+		sessions / taken.count(), duration<double, std::micro>(*p99).count());
+}
+
+// Not in the text: plays every session given on std::cin, one "session guess" pair per line.
+// A session starts with its first line, and anything that isn't a number gives up.
+void serve(std::istream& in, std::ostream& out)
+{
+	std::mutex out_mutex;
+	server::SessionServer server{ std::max(std::thread::hardware_concurrency(), 1u),
+		[&out, &out_mutex](uint64_t session, const game::Response& response) {
+			std::lock_guard lock{ out_mutex };
+			out << session << ": " << response.text;
+		} };
+	uint64_t session{};
+	while (in >> session)
+	{
+		server.guess(session, read_number(in));
+	}
+	server.stop();
+}
+
+// Run with --bench to time the faster prime checks and the solver instead of playing,
+// --replay file to play the last game with guesses from a file,
+// or --serve to play many sessions at once from std::cin
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && std::string_view(argv[1]) == "--bench")
+	{
+		benchmark_primality(std::cout);
+		benchmark_batch_primality(std::cout);
+		benchmark_solver(std::cout);
+		benchmark_number_reader(std::cout);
+		benchmark_sessions(std::cout);
+		return 0;
+	}
+	if (argc > 1 && std::string_view(argv[1]) == "--serve")
+	{
+		serve(std::cin, std::cout);
+		return 0;
+	}
+	if (argc > 2 && std::string_view(argv[1]) == "--replay")
+	{
+		std::ifstream file{ argv[2], std::ios::binary };
+		reader::NumberReader guesses{ file };
+		const int number = some_prime_number_from_sieve();
+		guess_number_with_more_clues(number,
+			clues::ClueChain{ clues::check_length, clues::check_prime, clues::CheckDigits{ static_cast<unsigned>(number) } },
+			guesses);
+		return 0;
+	}
+
 	check_properties();
 
 	// guess a number without a clue
@@ -242,14 +591,14 @@ int main()
 	// Listing 3.20
 	// Guess a prime number:
 	auto check_prime = [](int guess) {
-		return std::string((is_prime(guess)) ? "" : "Not prime\n");
+		return std::string((primes::is_prime_lookup(guess)) ? "" : "Not prime\n");
 	};
 
 	auto check_length = [](int guess) {
 		return std::string((guess < 100000) ? "" : "Too long\n");
 	};
 
-	const int number = some_prime_number();
+	const int number = some_prime_number_from_sieve();
 	auto check_digits = [number](int guess) {
 		return std::format("{}\n", 
 			check_which_digits_correct(number, guess));
@@ -261,4 +610,6 @@ int main()
 		check_digits
 	};
 	guess_number_with_more_clues(number, messages);
+	// or, without std::function or allocating any clues:
+	//guess_number_with_more_clues(number, clues::ClueChain{ clues::check_length, clues::check_prime, clues::CheckDigits{ static_cast<unsigned>(number) } });
 }
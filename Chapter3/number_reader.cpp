@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <system_error>
+
+#include "number_reader.h"
+
+namespace reader
+{
+	namespace
+	{
+		// The characters operator >> skips in the "C" locale
+		bool is_space(char c)
+		{
+			return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+		}
+	}
+
+	NumberReader::NumberReader(std::istream& in, size_t buffer_size)
+		: source_(in.rdbuf()), buffer_(std::max<size_t>(buffer_size, 16))
+	{
+	}
+
+	// Moves anything unread to the front, then reads as much as fits after it.
+	// Grows the buffer if a single token fills it.
+	bool NumberReader::refill()
+	{
+		if (finished_)
+		{
+			return false;
+		}
+		std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+		end_ -= begin_;
+		begin_ = 0;
+		if (end_ == buffer_.size())
+		{
+			buffer_.resize(buffer_.size() * 2);
+		}
+		auto count = source_->sgetn(buffer_.data() + end_, static_cast<std::streamsize>(buffer_.size() - end_));
+		if (count <= 0)
+		{
+			finished_ = true;
+			return false;
+		}
+		end_ += static_cast<size_t>(count);
+		return true;
+	}
+
+	void NumberReader::skip_line()
+	{
+		do
+		{
+			const char* first = buffer_.data() + begin_;
+			if (auto newline = static_cast<const char*>(std::memchr(first, '\n', end_ - begin_)))
+			{
+				begin_ += newline - first + 1;
+				return;
+			}
+			begin_ = end_;
+		} while (refill());
+	}
+
+	std::optional<unsigned> NumberReader::next()
+	{
+		while (true)
+		{
+			while (begin_ < end_ && is_space(buffer_[begin_]))
+			{
+				++begin_;
+			}
+			if (begin_ < end_)
+			{
+				break;
+			}
+			if (!refill())
+			{
+				return {};
+			}
+		}
+
+		// Make sure all of the token is in the buffer, so from_chars sees every digit
+		auto token_end = [this] {
+			return static_cast<size_t>(std::find_if(buffer_.begin() + begin_, buffer_.begin() + end_, is_space) - buffer_.begin());
+		};
+		while (token_end() == end_ && refill())
+		{
+		}
+		const size_t stop = token_end(); // refill moves the buffer along, even when it reads nothing
+
+		unsigned value{};
+		const char* first = buffer_.data() + begin_;
+		const char* digits = first;
+		if (*digits == '+') // from_chars doesn't take a plus sign, but operator >> does
+		{
+			++digits;
+		}
+		auto [last, error] = std::from_chars(digits, buffer_.data() + stop, value);
+		if (error != std::errc{})
+		{
+			skip_line();
+			return {};
+		}
+		begin_ += last - first; // like operator >>, anything after the digits is left for next time
+		return value;
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <optional>
+#include <streambuf>
+#include <vector>
+
+namespace reader
+{
+	// Reads unsigned numbers from scripted input, such as a file of guesses,
+	// a large block at a time, parsing with std::from_chars rather than operator >>.
+	// Gives the same numbers as read_number(std::istream&): anything that isn't a number,
+	// or is too big, gives an empty optional and the rest of its line is skipped.
+	// A number may start with a plus sign, as with operator >>, but unlike operator >>, a minus sign isn't part of a number.
+	// It reads ahead, so is meant for files rather than someone typing.
+	class NumberReader
+	{
+	public:
+		explicit NumberReader(std::istream& in, size_t buffer_size = 1 << 16);
+
+		std::optional<unsigned> next();
+	private:
+		bool refill();
+		void skip_line();
+
+		std::streambuf* source_;
+		std::vector<char> buffer_;
+		size_t begin_ = 0; // first unread character
+		size_t end_ = 0;   // one past the last character read in
+		bool finished_ = false;
+	};
+
+	// So games written against read_number(std::cin) can take a NumberReader instead
+	inline std::optional<unsigned> read_number(NumberReader& in)
+	{
+		return in.next();
+	}
+}
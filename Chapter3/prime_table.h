@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "primes.h"
+
+namespace primes
+{
+	// Every number the game picks is below this
+	constexpr uint32_t table_limit = 100000;
+
+	// One bit per number below table_limit, set for primes: about 12.5KB,
+	// sieved by the compiler and built into the program, so checking a guess is one bit test
+	class PrimeTable
+	{
+	public:
+		constexpr PrimeTable()
+		{
+			// Start with the odd numbers and 2, then only cross off odd multiples.
+			// Compilers limit how much one constant evaluation does (the project raises MSVC's /constexpr:steps too),
+			// so this does under half the work of a plain sieve.
+			for (auto& word : bits_)
+			{
+				word = 0xAAAA'AAAA'AAAA'AAAA;
+			}
+			clear(1);
+			bits_[0] |= uint64_t{ 1 } << 2;
+			for (uint32_t p = 3; p * p < table_limit; p += 2)
+			{
+				if (contains(p))
+				{
+					for (uint32_t multiple = p * p; multiple < table_limit; multiple += 2 * p)
+					{
+						clear(multiple);
+					}
+				}
+			}
+			for (uint32_t n = table_limit; n < bits_.size() * 64; ++n)
+			{
+				clear(n);
+			}
+		}
+
+		// n must be below table_limit
+		constexpr bool contains(uint32_t n) const
+		{
+			return (bits_[n / 64] >> (n % 64)) & 1;
+		}
+
+		constexpr size_t count() const
+		{
+			size_t total = 0;
+			for (uint64_t word : bits_)
+			{
+				total += std::popcount(word);
+			}
+			return total;
+		}
+	private:
+		constexpr void clear(uint32_t n)
+		{
+			bits_[n / 64] &= ~(uint64_t{ 1 } << (n % 64));
+		}
+
+		std::array<uint64_t, (table_limit + 63) / 64> bits_{};
+	};
+
+	inline constexpr PrimeTable prime_table{};
+
+	static_assert(prime_table.count() == 9592); // there are 9592 primes below 100000
+
+	// Every prime below table_limit, sieved the first time it's asked for,
+	// so a random one can be picked with a single index
+	inline const std::vector<uint32_t>& table_primes()
+	{
+		static const std::vector<uint32_t> primes = primes_below(table_limit);
+		return primes;
+	}
+
+	// The table for guesses the game could have picked, and Miller-Rabin for anything bigger
+	constexpr bool is_prime_lookup(int n)
+	{
+		if (n < 0)
+		{
+			return false;
+		}
+		return static_cast<uint32_t>(n) < table_limit ? prime_table.contains(static_cast<uint32_t>(n))
+			: is_prime(static_cast<uint64_t>(n));
+	}
+}
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+#include "primes.h"
+
+namespace
+{
+	// An odd prime p, with what we need to test n for divisibility by p without dividing.
+	// Multiplying by the inverse of p mod 2^32 maps multiples of p, and only those,
+	// onto 0, 1, ..., (2^32 - 1) / p.
+	struct Divisor
+	{
+		uint32_t p;
+		uint32_t inverse;
+		uint32_t max_quotient;
+	};
+
+	constexpr size_t batch_primes = 300;
+
+	constexpr std::array<Divisor, batch_primes> make_divisors()
+	{
+		std::array<Divisor, batch_primes> divisors{};
+		size_t found = 0;
+		for (uint32_t n = 3; found < batch_primes; n += 2)
+		{
+			if (!primes::is_prime(n))
+			{
+				continue;
+			}
+			uint32_t inverse = n; // Newton's method, as for Montgomery
+			for (int i = 0; i < 4; ++i)
+			{
+				inverse *= 2 - n * inverse;
+			}
+			divisors[found++] = { n, inverse, UINT32_MAX / n };
+		}
+		return divisors;
+	}
+
+	constexpr auto divisors = make_divisors();
+
+	// is_prime_batch tries the divisors in stages, dropping numbers with a factor after each one
+	constexpr size_t stage_ends[]{ 0, 3, 16, 64, batch_primes };
+}
+
+namespace primes
+{
+	uint64_t integer_sqrt(uint64_t n)
+	{
+		auto root = static_cast<uint64_t>(std::sqrt(static_cast<double>(n)));
+		while (root * root > n)
+		{
+			--root;
+		}
+		while ((root + 1) * (root + 1) <= n)
+		{
+			++root;
+		}
+		return root;
+	}
+
+	std::vector<uint32_t> odd_primes_up_to(uint32_t limit)
+	{
+		std::vector<uint32_t> odd_primes;
+		// composite[i] is for the odd number 2i + 1
+		std::vector<bool> composite(limit / 2 + 1);
+		for (uint64_t n = 3; n <= limit; n += 2)
+		{
+			if (composite[n / 2])
+			{
+				continue;
+			}
+			odd_primes.push_back(static_cast<uint32_t>(n));
+			for (uint64_t multiple = n * n; multiple <= limit; multiple += 2 * n)
+			{
+				composite[multiple / 2] = true;
+			}
+		}
+		return odd_primes;
+	}
+
+	void sieve_segment(uint64_t low, std::span<const uint32_t> odd_primes, std::span<uint64_t> bits)
+	{
+		std::ranges::fill(bits, ~uint64_t{ 0 });
+		const uint64_t odds = bits.size() * 64;
+		const uint64_t high = low + 2 * odds; // one past the last number in the segment
+		for (uint64_t p : odd_primes)
+		{
+			if (p * p >= high)
+			{
+				break;
+			}
+			// the first odd multiple of p in the segment, but never p itself
+			uint64_t first = std::max(p * p, (low + p - 1) / p * p);
+			if (first % 2 == 0)
+			{
+				first += p;
+			}
+			for (uint64_t idx = (first - low) / 2; idx < odds; idx += p)
+			{
+				bits[idx / 64] &= ~(uint64_t{ 1 } << (idx % 64));
+			}
+		}
+	}
+
+	std::vector<uint32_t> primes_below(uint32_t limit)
+	{
+		std::vector<uint32_t> primes;
+		for_each_prime(0, limit, [&primes](uint64_t p) { primes.push_back(static_cast<uint32_t>(p)); });
+		return primes;
+	}
+
+	PrimeIndex::PrimeIndex(uint64_t limit)
+		: limit_(limit),
+		odd_primes_(odd_primes_up_to(static_cast<uint32_t>(integer_sqrt(limit))))
+	{
+		std::vector<uint64_t> bits(segment_odds / 64);
+		for (uint64_t low = 3; low < limit_; low += 2 * segment_odds)
+		{
+			primes_before_segment_.push_back(count_);
+			sieve_segment(low, odd_primes_, bits);
+			const uint64_t in_range = std::min(segment_odds, (limit_ - low + 1) / 2);
+			for (uint64_t word = 0; word * 64 < in_range; ++word)
+			{
+				uint64_t current = bits[word];
+				if (in_range - word * 64 < 64)
+				{
+					current &= (uint64_t{ 1 } << (in_range - word * 64)) - 1;
+				}
+				count_ += std::popcount(current);
+			}
+		}
+	}
+
+	uint64_t PrimeIndex::count() const
+	{
+		return count_ + (limit_ > 2 ? 1 : 0);
+	}
+
+	uint64_t PrimeIndex::nth(uint64_t n) const
+	{
+		if (n >= count())
+		{
+			throw std::out_of_range("Not that many primes");
+		}
+		if (n == 0)
+		{
+			return 2;
+		}
+		const uint64_t odd_index = n - 1;
+		// the last segment starting with fewer than odd_index + 1 primes before it
+		auto segment = std::ranges::upper_bound(primes_before_segment_, odd_index) - 1;
+		const uint64_t low = 3 + 2 * segment_odds * (segment - primes_before_segment_.begin());
+		uint64_t remaining = odd_index - *segment;
+
+		std::vector<uint64_t> bits(segment_odds / 64);
+		sieve_segment(low, odd_primes_, bits);
+		for (size_t word = 0; ; ++word)
+		{
+			const uint64_t in_word = std::popcount(bits[word]);
+			if (remaining < in_word)
+			{
+				uint64_t current = bits[word];
+				for (; remaining; --remaining)
+				{
+					current &= current - 1;
+				}
+				return low + 2 * (64 * word + std::countr_zero(current));
+			}
+			remaining -= in_word;
+		}
+	}
+
+	void is_prime_batch(std::span<const uint32_t> candidates, std::span<uint8_t> result)
+	{
+		assert(candidates.size() == result.size());
+
+		constexpr size_t block = 256;
+		std::array<uint32_t, block> alive{};
+		std::array<uint32_t, block> alive_index{};
+		std::array<uint32_t, block> divisible{};
+		for (size_t start = 0; start < candidates.size(); start += block)
+		{
+			const size_t in_block = std::min(block, candidates.size() - start);
+			size_t count = 0;
+			for (size_t lane = 0; lane < in_block; ++lane)
+			{
+				const uint32_t candidate = candidates[start + lane];
+				result[start + lane] = candidate == 2;
+				if (candidate > 2 && candidate % 2)
+				{
+					alive[count] = candidate;
+					alive_index[count++] = static_cast<uint32_t>(start + lane);
+				}
+			}
+
+			// Most numbers have a small factor, so check a few divisors then drop the numbers found out,
+			// and only carry on with the rest, much like trial division stopping early
+			for (size_t stage = 0; stage + 1 < std::size(stage_ends) && count; ++stage)
+			{
+				std::fill_n(divisible.begin(), count, 0);
+				for (size_t d = stage_ends[stage]; d < stage_ends[stage + 1]; ++d)
+				{
+					const Divisor divisor = divisors[d];
+					// the same operations on every number, without branches, so this loop vectorises
+					for (size_t i = 0; i < count; ++i)
+					{
+						const bool divides = static_cast<uint32_t>(alive[i] * divisor.inverse) <= divisor.max_quotient;
+						divisible[i] |= divides & (alive[i] != divisor.p);
+					}
+				}
+				// no factor up to the last divisor checked means below its square is prime
+				const uint64_t checked = divisors[stage_ends[stage + 1] - 1].p;
+				size_t kept = 0;
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (divisible[i])
+					{
+						continue;
+					}
+					if (alive[i] < checked * checked)
+					{
+						result[alive_index[i]] = 1;
+						continue;
+					}
+					alive[kept] = alive[i];
+					alive_index[kept++] = alive_index[i];
+				}
+				count = kept;
+			}
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				result[alive_index[i]] = miller_rabin(alive[i]);
+			}
+		}
+	}
+}
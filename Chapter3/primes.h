@@ -0,0 +1,330 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace primes
+{
+	namespace detail
+	{
+		// The full 128-bit product of a and b, as high and low halves
+		constexpr void multiply_wide(uint64_t a, uint64_t b, uint64_t& high, uint64_t& low)
+		{
+#ifdef __SIZEOF_INT128__
+			const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+			high = static_cast<uint64_t>(product >> 64);
+			low = static_cast<uint64_t>(product);
+#else
+			const uint64_t a_low = a & 0xFFFFFFFF, a_high = a >> 32;
+			const uint64_t b_low = b & 0xFFFFFFFF, b_high = b >> 32;
+			const uint64_t low_low = a_low * b_low;
+			const uint64_t high_low = a_high * b_low;
+			const uint64_t low_high = a_low * b_high;
+			const uint64_t middle = (low_low >> 32) + (high_low & 0xFFFFFFFF) + (low_high & 0xFFFFFFFF);
+			high = a_high * b_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+			low = (middle << 32) | (low_low & 0xFFFFFFFF);
+#endif
+		}
+
+		// Arithmetic mod an odd n, keeping numbers as x * 2^64 mod n,
+		// so multiplying needs no division
+		class Montgomery
+		{
+		public:
+			constexpr explicit Montgomery(uint64_t n) : n_(n)
+			{
+				// Newton's method: each step doubles the number of correct low bits
+				inverse_ = n;
+				for (int i = 0; i < 5; ++i)
+				{
+					inverse_ *= 2 - n * inverse_;
+				}
+				one_ = (0 - n) % n; // 2^64 mod n
+#ifdef __SIZEOF_INT128__
+				r_squared_ = static_cast<uint64_t>(static_cast<unsigned __int128>(one_) * one_ % n);
+#else
+				r_squared_ = one_;
+				for (int i = 0; i < 64; ++i)
+				{
+					r_squared_ = add(r_squared_, r_squared_);
+				}
+#endif
+			}
+
+			constexpr uint64_t one() const { return one_; }
+			constexpr uint64_t to_montgomery(uint64_t x) const { return multiply(x % n_, r_squared_); }
+
+			constexpr uint64_t add(uint64_t a, uint64_t b) const
+			{
+				return a >= n_ - b ? a - (n_ - b) : a + b;
+			}
+
+			constexpr uint64_t multiply(uint64_t a, uint64_t b) const
+			{
+				uint64_t high = 0, low = 0;
+				multiply_wide(a, b, high, low);
+				return reduce(high, low);
+			}
+
+			constexpr uint64_t power(uint64_t base, uint64_t exponent) const
+			{
+				uint64_t result = one_;
+				while (exponent)
+				{
+					if (exponent & 1)
+					{
+						result = multiply(result, base);
+					}
+					base = multiply(base, base);
+					exponent >>= 1;
+				}
+				return result;
+			}
+		private:
+			// (high * 2^64 + low) / 2^64 mod n
+			constexpr uint64_t reduce(uint64_t high, uint64_t low) const
+			{
+				const uint64_t m = low * inverse_;
+				uint64_t mn_high = 0, mn_low = 0;
+				multiply_wide(m, n_, mn_high, mn_low);
+				return high >= mn_high ? high - mn_high : high - mn_high + n_;
+			}
+
+			uint64_t n_;
+			uint64_t inverse_ = 0;
+			uint64_t one_ = 0;
+			uint64_t r_squared_ = 0;
+		};
+
+		// The same for n below 2^32, where the products fit in 64 bits
+		class Montgomery32
+		{
+		public:
+			constexpr Montgomery32() = default;
+			constexpr explicit Montgomery32(uint32_t n) : n_(n)
+			{
+				inverse_ = n;
+				for (int i = 0; i < 4; ++i)
+				{
+					inverse_ *= 2 - n * inverse_;
+				}
+				one_ = static_cast<uint32_t>((uint64_t{ 1 } << 32) % n);
+				r_squared_ = static_cast<uint32_t>(uint64_t{ one_ } * one_ % n);
+			}
+
+			constexpr uint32_t one() const { return one_; }
+			constexpr uint32_t to_montgomery(uint64_t x) const
+			{
+				return multiply(static_cast<uint32_t>(x % n_), r_squared_);
+			}
+
+			constexpr uint32_t multiply(uint32_t a, uint32_t b) const
+			{
+				const uint64_t product = uint64_t{ a } * b;
+				const uint32_t m = static_cast<uint32_t>(product) * inverse_;
+				const uint32_t high = static_cast<uint32_t>(product >> 32);
+				const uint32_t mn_high = static_cast<uint32_t>((uint64_t{ m } * n_) >> 32);
+				return high >= mn_high ? high - mn_high : high - mn_high + n_;
+			}
+
+			constexpr uint32_t power(uint32_t base, uint64_t exponent) const
+			{
+				uint32_t result = one_;
+				while (exponent)
+				{
+					if (exponent & 1)
+					{
+						result = multiply(result, base);
+					}
+					base = multiply(base, base);
+					exponent >>= 1;
+				}
+				return result;
+			}
+		private:
+			uint32_t n_ = 1;
+			uint32_t inverse_ = 1;
+			uint32_t one_ = 0;
+			uint32_t r_squared_ = 0;
+		};
+
+		// Is n a strong probable prime to base a? n must be odd and above 2
+		template<typename M>
+		constexpr bool strong_probable_prime(const M& mont, uint64_t n, uint64_t a)
+		{
+			uint64_t d = n - 1;
+			int s = 0;
+			while (d % 2 == 0)
+			{
+				d /= 2;
+				++s;
+			}
+			const auto x_start = mont.to_montgomery(a);
+			if (x_start == 0)
+			{
+				return true; // a is a multiple of n, so tells us nothing
+			}
+			const auto minus_one = mont.to_montgomery(n - 1);
+			auto x = mont.power(x_start, d);
+			if (x == mont.one() || x == minus_one)
+			{
+				return true;
+			}
+			for (int r = 1; r < s; ++r)
+			{
+				x = mont.multiply(x, x);
+				if (x == minus_one)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+	}
+
+	// Deterministic for every 64-bit n: no composite number passes all these witnesses
+	// https://miller-rabin.appspot.com/
+	constexpr bool miller_rabin(uint64_t n)
+	{
+		if (n < 2 || n % 2 == 0)
+		{
+			return n == 2;
+		}
+		if (n < (uint64_t{ 1 } << 32))
+		{
+			const detail::Montgomery32 mont(static_cast<uint32_t>(n));
+			for (uint64_t a : { 2, 7, 61 })
+			{
+				if (!detail::strong_probable_prime(mont, n, a))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+		const detail::Montgomery mont(n);
+		for (uint64_t a : { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 })
+		{
+			if (!detail::strong_probable_prime(mont, n, a))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Small primes used for trial division before Miller-Rabin
+	constexpr uint32_t small_primes[]{ 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53 };
+
+	// Trial division by a few small primes catches most composites cheaply,
+	// then Miller-Rabin decides the rest
+	constexpr bool is_prime(uint64_t n)
+	{
+		for (uint64_t p : small_primes)
+		{
+			if (n % p == 0)
+			{
+				return n == p;
+			}
+		}
+		if (n < 59 * 59)
+		{
+			return n > 1; // no factor up to 53, and the next prime is 59
+		}
+		return miller_rabin(n);
+	}
+
+	static_assert(!is_prime(0) && !is_prime(1) && is_prime(2) && is_prime(3) && !is_prime(4));
+	static_assert(is_prime(56897) && !is_prime(56899));
+	static_assert(!is_prime(3'215'031'751)); // a strong pseudoprime to bases 2, 3, 5 and 7
+	static_assert(!is_prime(3'825'123'056'546'413'051)); // a strong pseudoprime to the first nine prime bases
+	static_assert(is_prime(18'446'744'073'709'551'557u)); // the largest 64-bit prime
+	static_assert(!is_prime(18'446'744'073'709'551'615u));
+
+	// Sets result[i] to 1 if candidates[i] is prime, or 0 if not, for many candidates at a time.
+	// A block of candidates is checked against the first few hundred primes together,
+	// using a multiply and compare instead of division so the compiler can vectorise it,
+	// and only the survivors need miller_rabin.
+	// result must be the same size as candidates.
+	void is_prime_batch(std::span<const uint32_t> candidates, std::span<uint8_t> result);
+
+	// Odd numbers covered by each segment of the sieve: 32KB of bits, so a segment fits in cache
+	constexpr uint64_t segment_odds = 1 << 18;
+
+	// The largest r with r * r <= n
+	uint64_t integer_sqrt(uint64_t n);
+
+	// Odd primes up to and including limit, from a simple sieve, used to sieve the segments
+	std::vector<uint32_t> odd_primes_up_to(uint32_t limit);
+
+	// Sieves the odd numbers low, low + 2, low + 4, ..., one per bit.
+	// Bit i ends up set if low + 2i is prime.
+	// low must be odd and above 1, and odd_primes must go up to the square root of the last number
+	void sieve_segment(uint64_t low, std::span<const uint32_t> odd_primes, std::span<uint64_t> bits);
+
+	// Calls f for every prime in [from, to), in order, holding one segment in memory at a time
+	template<typename F>
+	void for_each_prime(uint64_t from, uint64_t to, F f)
+	{
+		if (from <= 2 && 2 < to)
+		{
+			f(uint64_t{ 2 });
+		}
+		uint64_t low = std::max<uint64_t>(from, 3) | 1;
+		if (low >= to)
+		{
+			return;
+		}
+		const auto odd_primes = odd_primes_up_to(static_cast<uint32_t>(integer_sqrt(to)));
+		std::vector<uint64_t> bits(segment_odds / 64);
+		for (; low < to; low += 2 * segment_odds)
+		{
+			sieve_segment(low, odd_primes, bits);
+			for (size_t word = 0; word < bits.size(); ++word)
+			{
+				for (uint64_t remaining = bits[word]; remaining; remaining &= remaining - 1)
+				{
+					const uint64_t n = low + 2 * (64 * word + std::countr_zero(remaining));
+					if (n >= to)
+					{
+						return;
+					}
+					f(n);
+				}
+			}
+		}
+	}
+
+	// Every prime below limit, for picking one at random in O(1)
+	std::vector<uint32_t> primes_below(uint32_t limit);
+
+	// For ranges too big to list every prime: keeps a count of primes per segment,
+	// and sieves a single segment again to find the nth one
+	class PrimeIndex
+	{
+	public:
+		// Primes below limit
+		explicit PrimeIndex(uint64_t limit);
+
+		uint64_t count() const;
+
+		// Counting from zero, so nth(0) is 2
+		uint64_t nth(uint64_t n) const;
+
+		template<typename Generator>
+		uint64_t random_prime(Generator& gen) const
+		{
+			std::uniform_int_distribution<uint64_t> dist{ 0, count() - 1 };
+			return nth(dist(gen));
+		}
+	private:
+		uint64_t limit_;
+		std::vector<uint32_t> odd_primes_;
+		std::vector<uint64_t> primes_before_segment_; // odd primes only; 2 is dealt with separately
+		uint64_t count_ = 0;
+	};
+}
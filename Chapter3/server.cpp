@@ -0,0 +1,147 @@
+#include <algorithm>
+
+#include "prime_table.h"
+#include "random_engine.h"
+#include "server.h"
+
+namespace server
+{
+	namespace
+	{
+		unsigned random_prime()
+		{
+			const auto& table = primes::table_primes();
+			std::uniform_int_distribution<size_t> dist{ 0, table.size() - 1 };
+			return table[dist(rng::engine())];
+		}
+	}
+
+	SessionServer::SessionServer(unsigned threads, Reply reply, bool record_latencies)
+		: reply_(std::move(reply)), record_latencies_(record_latencies)
+	{
+		for (unsigned idx = 0; idx < std::max(threads, 1u); ++idx)
+		{
+			workers_.push_back(std::make_unique<Worker>());
+		}
+		for (auto& worker : workers_)
+		{
+			worker->thread = std::jthread([this, &worker = *worker](std::stop_token stop) { run(worker, stop); });
+		}
+	}
+
+	SessionServer::~SessionServer()
+	{
+		stop();
+	}
+
+	void SessionServer::open(uint64_t session, std::optional<unsigned> number)
+	{
+		submit({ session, {}, number ? number.value() : random_prime(), std::chrono::steady_clock::now() });
+	}
+
+	void SessionServer::guess(uint64_t session, std::optional<unsigned> guess)
+	{
+		submit({ session, guess, {}, std::chrono::steady_clock::now() });
+	}
+
+	void SessionServer::submit(Request request)
+	{
+		auto& worker = *workers_[request.session % workers_.size()];
+		{
+			std::lock_guard lock{ worker.mutex };
+			worker.queue.push_back(request);
+		}
+		worker.ready.notify_one();
+	}
+
+	void SessionServer::stop()
+	{
+		for (auto& worker : workers_)
+		{
+			worker->thread.request_stop();
+		}
+		for (auto& worker : workers_)
+		{
+			if (worker->thread.joinable())
+			{
+				worker->thread.join();
+			}
+		}
+	}
+
+	// Takes everything queued in one go, so the lock is held once per batch rather than per request
+	void SessionServer::run(Worker& worker, std::stop_token stop)
+	{
+		std::vector<Request> batch;
+		while (true)
+		{
+			{
+				std::unique_lock lock{ worker.mutex };
+				worker.ready.wait(lock, stop, [&worker] { return !worker.queue.empty(); });
+				if (worker.queue.empty())
+				{
+					return; // stopped, with nothing left to do
+				}
+				std::swap(batch, worker.queue);
+			}
+			for (const auto& request : batch)
+			{
+				handle(worker, request);
+			}
+			batch.clear();
+		}
+	}
+
+	void SessionServer::handle(Worker& worker, const Request& request)
+	{
+		auto session = worker.sessions.find(request.session);
+		if (request.number || session == worker.sessions.end())
+		{
+			const unsigned number = request.number ? request.number.value() : random_prime();
+			session = worker.sessions.insert_or_assign(request.session, game::Session{ number }).first;
+			if (request.number)
+			{
+				reply_(request.session, { game::State::Playing, std::string(game::Session::greeting()) });
+				record(worker, request);
+				return;
+			}
+		}
+
+		const auto response = session->second.step(request.guess);
+		if (response.state != game::State::Playing)
+		{
+			worker.sessions.erase(session);
+			++worker.finished;
+		}
+		reply_(request.session, response);
+		record(worker, request);
+	}
+
+	void SessionServer::record(Worker& worker, const Request& request) const
+	{
+		if (record_latencies_)
+		{
+			worker.latencies.push_back(std::chrono::steady_clock::now() - request.submitted);
+		}
+	}
+
+	size_t SessionServer::sessions_finished() const
+	{
+		size_t total = 0;
+		for (const auto& worker : workers_)
+		{
+			total += worker->finished;
+		}
+		return total;
+	}
+
+	std::vector<std::chrono::nanoseconds> SessionServer::step_latencies() const
+	{
+		std::vector<std::chrono::nanoseconds> all;
+		for (const auto& worker : workers_)
+		{
+			all.insert(all.end(), worker->latencies.begin(), worker->latencies.end());
+		}
+		return all;
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "game.h"
+
+namespace server
+{
+	struct Request
+	{
+		uint64_t session;
+		std::optional<unsigned> guess;
+		std::optional<unsigned> number; // set to open a session with this number
+		std::chrono::steady_clock::time_point submitted;
+	};
+
+	// Called on a worker thread with each session's answer
+	using Reply = std::function<void(uint64_t session, const game::Response& response)>;
+
+	// Plays many game::Sessions at once over a few threads.
+	// Each session belongs to one worker, picked from its id, so a session's requests
+	// are handled in order and its state is only ever touched by that worker, without locks.
+	class SessionServer
+	{
+	public:
+		// Only keeps step latencies if asked, as they grow with every request
+		SessionServer(unsigned threads, Reply reply, bool record_latencies = false);
+		~SessionServer();
+
+		// Starts a session; without a number it picks a random prime below 100000
+		void open(uint64_t session, std::optional<unsigned> number = {});
+		// A guess for an open session, or nothing to give up.
+		// A guess for a session that isn't open opens one first.
+		void guess(uint64_t session, std::optional<unsigned> guess);
+
+		// Finishes every request already submitted, then stops the workers
+		void stop();
+
+		// Call these after stop
+		size_t sessions_finished() const;
+		// How long each step took, from being submitted to its reply; empty unless recording
+		std::vector<std::chrono::nanoseconds> step_latencies() const;
+	private:
+		struct Worker
+		{
+			std::mutex mutex;
+			std::condition_variable_any ready;
+			std::vector<Request> queue;
+			std::unordered_map<uint64_t, game::Session> sessions;
+			std::vector<std::chrono::nanoseconds> latencies;
+			size_t finished = 0;
+			std::jthread thread;
+		};
+
+		void submit(Request request);
+		void run(Worker& worker, std::stop_token stop);
+		void handle(Worker& worker, const Request& request);
+		void record(Worker& worker, const Request& request) const;
+
+		Reply reply_;
+		bool record_latencies_;
+		std::vector<std::unique_ptr<Worker>> workers_;
+	};
+}
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "digits.h"
+#include "primes.h"
+#include "solver.h"
+
+namespace solver
+{
+	Clue encode(std::span<const char> matches)
+	{
+		Clue clue = 0;
+		for (char match : matches)
+		{
+			clue = static_cast<Clue>(clue * 3 + (match == '*' ? 2 : match == '^' ? 1 : 0));
+		}
+		return clue;
+	}
+
+	Candidate make_candidate(unsigned value)
+	{
+		Candidate candidate{ value, {}, {} };
+		digits::to_digits(value, candidate.digits);
+		for (auto digit : candidate.digits)
+		{
+			++candidate.histogram[digit];
+		}
+		return candidate;
+	}
+
+	// Like digits::check_which_digits_correct, but starting from number's histogram
+	// and producing the encoded clue straight away
+	Clue clue_for(const Candidate& number, const Candidate& guess)
+	{
+		auto unmatched = number.histogram;
+		std::array<uint8_t, digit_count> marks{};
+		for (size_t i = 0; i < digit_count; ++i)
+		{
+			if (guess.digits[i] == number.digits[i])
+			{
+				marks[i] = 2;
+				--unmatched[guess.digits[i]];
+			}
+		}
+		Clue clue = 0;
+		for (size_t i = 0; i < digit_count; ++i)
+		{
+			if (marks[i] == 0 && unmatched[guess.digits[i]])
+			{
+				marks[i] = 1;
+				--unmatched[guess.digits[i]];
+			}
+			clue = static_cast<Clue>(clue * 3 + marks[i]);
+		}
+		return clue;
+	}
+
+	Solver::Solver()
+	{
+		for (auto prime : primes::primes_below(100000))
+		{
+			all_.push_back(make_candidate(prime));
+		}
+		candidates_ = all_;
+		first_guess_ = best_guess().value;
+	}
+
+	void Solver::reset()
+	{
+		candidates_ = all_;
+		guesses_ = 0;
+	}
+
+	unsigned Solver::next_guess()
+	{
+		if (guesses_ == 0)
+		{
+			return first_guess_;
+		}
+		if (guesses_ == 1)
+		{
+			auto& second = second_guesses_[first_clue_];
+			if (second == 0) // 0 isn't prime, so never a guess
+			{
+				second = best_guess().value;
+			}
+			return second;
+		}
+		return best_guess().value;
+	}
+
+	void Solver::record(unsigned guess, Clue clue)
+	{
+		if (guesses_++ == 0)
+		{
+			first_clue_ = clue;
+		}
+		const auto guessed = make_candidate(guess);
+		std::erase_if(candidates_, [&](const Candidate& candidate) {
+			return clue_for(candidate, guessed) != clue;
+		});
+	}
+
+	// Try each remaining candidate as the guess, and count how many candidates each clue
+	// would leave. The expected number left is the sum of their squares over the total.
+	const Candidate& Solver::best_guess() const
+	{
+		assert(!candidates_.empty());
+		const Candidate* best = &candidates_.front();
+		size_t best_score = std::numeric_limits<size_t>::max();
+		std::array<uint32_t, clue_count> left{};
+		for (const auto& guess : candidates_)
+		{
+			left.fill(0);
+			for (const auto& candidate : candidates_)
+			{
+				++left[clue_for(candidate, guess)];
+			}
+			size_t score = 0;
+			for (size_t count : left)
+			{
+				score += count * count;
+			}
+			if (score < best_score)
+			{
+				best_score = score;
+				best = &guess;
+			}
+		}
+		return *best;
+	}
+
+	size_t play(Solver& solver, unsigned number)
+	{
+		solver.reset();
+		for (size_t guesses = 1; ; ++guesses)
+		{
+			const unsigned guess = solver.next_guess();
+			if (guess == number)
+			{
+				return guesses;
+			}
+			const auto matches = digits::which_digits_correct<digit_count>(number, guess);
+			solver.record(guess, encode(matches));
+		}
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace solver
+{
+	constexpr size_t digit_count = 5;
+
+	// A clue from check_which_digits_correct, as a number:
+	// each position is 0 for '.', 1 for '^' and 2 for '*', read as base 3
+	using Clue = uint8_t;
+	constexpr Clue clue_count = 243; // 3^5
+	constexpr Clue solved = clue_count - 1; // *****
+
+	Clue encode(std::span<const char> matches);
+
+	// A possible answer, with its digits and how many of each digit it has worked out up front
+	struct Candidate
+	{
+		unsigned value;
+		std::array<uint8_t, digit_count> digits;
+		std::array<uint8_t, 10> histogram;
+	};
+
+	Candidate make_candidate(unsigned value);
+
+	// The clue the game would give for guess if the answer were number
+	Clue clue_for(const Candidate& number, const Candidate& guess);
+
+	// Plays the prime guessing game without std::cin.
+	// Keeps the primes consistent with every clue so far and guesses the one
+	// that leaves the fewest candidates on average, whichever clue comes back.
+	class Solver
+	{
+	public:
+		Solver();
+
+		// Start a new game
+		void reset();
+
+		unsigned next_guess();
+		void record(unsigned guess, Clue clue);
+
+		size_t candidates_left() const { return candidates_.size(); }
+	private:
+		const Candidate& best_guess() const;
+
+		std::vector<Candidate> all_;
+		std::vector<Candidate> candidates_;
+		size_t guesses_ = 0;
+		Clue first_clue_ = 0;
+		unsigned first_guess_ = 0;
+		// the second guess only depends on the clue for the first, so work each one out once
+		std::array<unsigned, clue_count> second_guesses_{};
+	};
+
+	// Plays one game against number, a prime below 100000, giving the clues from
+	// digits::check_which_digits_correct, and returns how many guesses it took
+	size_t play(Solver& solver, unsigned number);
+}
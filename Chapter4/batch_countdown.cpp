@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <cassert>
+#include <execution>
+#include <vector>
+
+#include "batch_countdown.h"
+
+namespace calendar
+{
+    namespace
+    {
+        using std::chrono::system_clock;
+
+        constexpr auto ticks_per_day = std::chrono::duration_cast<system_clock::duration>(std::chrono::days{ 1 }).count();
+        constexpr size_t block_size = 1 << 14;
+
+        // Works on the raw counts, so there's nothing in the way of the vectoriser
+        void countdown_block(system_clock::rep now, const std::chrono::sys_days* events,
+            system_clock::duration* durations, size_t count)
+        {
+            for (size_t idx = 0; idx < count; ++idx)
+            {
+                const system_clock::rep day = events[idx].time_since_epoch().count();
+                durations[idx] = system_clock::duration{ day * ticks_per_day - now };
+            }
+        }
+    }
+
+    void countdowns_to_sequential(system_clock::time_point now,
+        std::span<const std::chrono::sys_days> events,
+        std::span<system_clock::duration> durations)
+    {
+        assert(durations.size() >= events.size());
+        countdown_block(now.time_since_epoch().count(), events.data(), durations.data(), events.size());
+    }
+
+    // Each core gets whole blocks, so the inner loop is still the vectorised one
+    void countdowns_to(system_clock::time_point now,
+        std::span<const std::chrono::sys_days> events,
+        std::span<system_clock::duration> durations)
+    {
+        if (events.size() < parallel_threshold)
+        {
+            countdowns_to_sequential(now, events, durations);
+            return;
+        }
+        assert(durations.size() >= events.size());
+        std::vector<size_t> starts((events.size() + block_size - 1) / block_size);
+        for (size_t idx = 0; idx < starts.size(); ++idx)
+        {
+            starts[idx] = idx * block_size;
+        }
+        const auto now_ticks = now.time_since_epoch().count();
+        std::for_each(std::execution::par_unseq, starts.begin(), starts.end(),
+            [now_ticks, events, durations](size_t start) {
+                countdown_block(now_ticks, events.data() + start, durations.data() + start,
+                    std::min(block_size, events.size() - start));
+            });
+    }
+}
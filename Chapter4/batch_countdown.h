@@ -0,0 +1,24 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <span>
+
+namespace calendar
+{
+    // Calendars at least this big are split across cores
+    constexpr size_t parallel_threshold = 1 << 20;
+
+    // countdown_to for many events at once. The events' days and the durations each live
+    // in their own contiguous array, so the loop is one widen, multiply and subtract per event,
+    // which the compiler can vectorise. Large calendars go through std::execution::par_unseq.
+    // durations must be at least as long as events.
+    void countdowns_to(std::chrono::system_clock::time_point now,
+        std::span<const std::chrono::sys_days> events,
+        std::span<std::chrono::system_clock::duration> durations);
+
+    // Always on this thread
+    void countdowns_to_sequential(std::chrono::system_clock::time_point now,
+        std::span<const std::chrono::sys_days> events,
+        std::span<std::chrono::system_clock::duration> durations);
+}
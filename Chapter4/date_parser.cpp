@@ -0,0 +1,133 @@
+#include <cstring>
+
+#include "date_parser.h"
+
+namespace calendar
+{
+    namespace
+    {
+        unsigned digit(char c)
+        {
+            return static_cast<unsigned char>(c) - unsigned{ '0' };
+        }
+
+        // Checks every character with & rather than &&, so there's one branch rather than ten
+        bool split_date(const char* text, int& y, unsigned& m, unsigned& d)
+        {
+            const unsigned y0 = digit(text[0]), y1 = digit(text[1]), y2 = digit(text[2]), y3 = digit(text[3]);
+            const unsigned m0 = digit(text[5]), m1 = digit(text[6]);
+            const unsigned d0 = digit(text[8]), d1 = digit(text[9]);
+            const bool digits = (y0 <= 9) & (y1 <= 9) & (y2 <= 9) & (y3 <= 9)
+                & (m0 <= 9) & (m1 <= 9) & (d0 <= 9) & (d1 <= 9);
+            y = static_cast<int>(y0 * 1000 + y1 * 100 + y2 * 10 + y3);
+            m = m0 * 10 + m1;
+            d = d0 * 10 + d1;
+            return digits & (text[4] == '-') & (text[7] == '-');
+        }
+
+        constexpr unsigned char month_lengths[13] = { 0, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+        // The same as sys_days{ year_month_day } when ok(), for years 0 to 9999,
+        // using Howard Hinnant's days_from_civil with plain ints
+        bool to_days(int y, unsigned m, unsigned d, std::chrono::sys_days& result)
+        {
+            if (m - 1 > 11 || d - 1 >= month_lengths[m])
+            {
+                return false;
+            }
+            if (m == 2 && d == 29 && !std::chrono::year{ y }.is_leap())
+            {
+                return false;
+            }
+            y -= m <= 2;
+            const int era = (y >= 0 ? y : y - 399) / 400;
+            const unsigned year_of_era = static_cast<unsigned>(y - era * 400);
+            const unsigned day_of_year = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+            const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+            result = std::chrono::sys_days{ std::chrono::days{ era * 146097 + static_cast<int>(day_of_era) - 719468 } };
+            return true;
+        }
+    }
+
+    std::optional<std::chrono::year_month_day> parse_date(std::string_view text)
+    {
+        using namespace std::chrono;
+        int y{};
+        unsigned m{}, d{};
+        if (text.size() != 10 || !split_date(text.data(), y, m, d))
+        {
+            return {};
+        }
+        const year_month_day date{ year{ y }, month{ m }, day{ d } };
+        if (!date.ok())
+        {
+            return {};
+        }
+        return date;
+    }
+
+    size_t read_dates(std::istream& in, std::vector<std::chrono::sys_days>& dates)
+    {
+        constexpr size_t block = 1 << 20;
+        std::vector<char> buffer(block);
+        size_t kept = 0; // the start of a line carried over from the last block
+        size_t bad = 0;
+        auto parse_line = [&dates, &bad](const char* first, size_t count) {
+            if (count && first[count - 1] == '\r')
+            {
+                --count;
+            }
+            if (count == 0)
+            {
+                return;
+            }
+            int y{};
+            unsigned m{}, d{};
+            std::chrono::sys_days date;
+            if (count == 10 && split_date(first, y, m, d) && to_days(y, m, d, date))
+            {
+                dates.push_back(date);
+            }
+            else
+            {
+                ++bad;
+            }
+        };
+
+        while (true)
+        {
+            if (kept == buffer.size())
+            {
+                buffer.resize(buffer.size() * 2); // one very long line
+            }
+            in.read(buffer.data() + kept, static_cast<std::streamsize>(buffer.size() - kept));
+            const size_t end = kept + static_cast<size_t>(in.gcount());
+            if (end == kept)
+            {
+                parse_line(buffer.data(), kept); // the last line may not end with a newline
+                return bad;
+            }
+            const char* line = buffer.data();
+            const char* stop = buffer.data() + end;
+            while (true)
+            {
+                // most lines are just a date, so try that before searching for the newline
+                if (stop - line > 10 && line[10] == '\n')
+                {
+                    parse_line(line, 10);
+                    line += 11;
+                    continue;
+                }
+                auto newline = static_cast<const char*>(std::memchr(line, '\n', stop - line));
+                if (!newline)
+                {
+                    break;
+                }
+                parse_line(line, newline - line);
+                line = newline + 1;
+            }
+            kept = stop - line;
+            std::memmove(buffer.data(), line, kept);
+        }
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace calendar
+{
+    // Exactly "YYYY-MM-DD", such as 2022-12-31, without a stream or locale.
+    // Gives the same year_month_day as read_date, and nothing if it isn't a real date.
+    // Unlike std::chrono::parse, the month and day need both digits.
+    std::optional<std::chrono::year_month_day> parse_date(std::string_view text);
+
+    // Reads a date per line, a large block at a time, adding each to dates.
+    // Blank lines are skipped; returns how many other lines weren't dates.
+    size_t read_dates(std::istream& in, std::vector<std::chrono::sys_days>& dates);
+}
@@ -8,10 +8,20 @@
 // std::cout << 
 //#include <date/date.h>
 #include <cassert>
+#include <format>
 #include <iostream>
 #include <optional>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <vector>
+
+#include "batch_countdown.h"
+#include "date_parser.h"
+#include "month_table.h"
+#include "timer_wheel.h"
+#include "zone_cache.h"
 
 //Listing 4.2 Duration between two time points
 void duration_to_end_of_year()
@@ -144,6 +154,17 @@ std::chrono::system_clock::duration countdown(std::chrono::system_clock::time_po
     return event - start;
 }
 
+// Not in the text: countdown to pay day, as Listing 4.8, with the last Friday from a table
+constexpr
+std::chrono::system_clock::duration countdown_to_pay_day(std::chrono::system_clock::time_point start)
+{
+    using namespace std::chrono;
+
+    const auto ymd = year_month_day{ floor<days>(start) };
+    auto event = sys_days(calendar::pay_day(ymd.year() / ymd.month()));
+    return event - start;
+}
+
 //Listing 4.12 Reading a date
 std::optional<std::chrono::year_month_day> read_date(std::istream& in)
 {
@@ -180,6 +201,17 @@ countdown_in_local_time(std::chrono::system_clock::time_point now,
     return sys_event - now;
 }
 
+// Not in the text: the same, with the zone looked up once and its offsets cached
+std::chrono::system_clock::duration
+countdown_in_local_time(std::chrono::system_clock::time_point now,
+    std::chrono::year_month_day date,
+    const calendar::ZoneHandle& zone)
+{
+    using namespace std::chrono;
+    auto sys_event = zone.to_sys(local_days{ date });
+    return sys_event - now;
+}
+
 //Listing 4.10 Check the countdown function
 void check_properties()
 {
@@ -190,14 +222,240 @@ void check_properties()
 
     static_assert(duration_cast<days>(result) == days{ 1 });
 
+    // Pay day from the table matches the arithmetic in Listing 4.8
+    constexpr auto first_of_december = sys_days{ 2022y / December / 1 };
+    static_assert(countdown_to_pay_day(first_of_december) == sys_days{ 2022y / December / Friday[last] } - first_of_december);
+    static_assert(calendar::last_day(2022y / December) == new_years_eve);
+
     // An example of another test, not included in the text of the book
     auto now = sys_days{ 2022y / March / 27 };
     auto difference = duration_cast<hours>(countdown_in_local_time(now, 2022y / March / 28));
     // assert(difference == 23h); // The assert works for the "Europe/London" time zone. Yours might vary
+
+    // The cached zone agrees with zoned_time, whichever zone you are in
+    const calendar::ZoneHandle zone;
+    for (auto date : { 2022y / March / 27, 2022y / March / 28, 2022y / October / 30, 2022y / October / 31 })
+    {
+        assert(countdown_in_local_time(now, date, zone) == countdown_in_local_time(now, date));
+    }
+
+    // The batch gives the same as one countdown_to at a time
+    const std::vector<sys_days> events{ 1970y / January / 1, 2022y / March / 28, 2022y / December / 31, 2100y / February / 28 };
+    std::vector<system_clock::duration> durations(events.size());
+    calendar::countdowns_to(now, events, durations);
+    for (size_t idx = 0; idx < events.size(); ++idx)
+    {
+        assert(durations[idx] == countdown_to(now, year_month_day{ events[idx] }));
+    }
+
+    // The fast parser agrees with read_date, and rejects dates that aren't ok()
+    for (auto text : { "2022-12-31", "2024-02-29", "0001-01-01" })
+    {
+        std::istringstream in(text);
+        assert(calendar::parse_date(text) == read_date(in));
+    }
+    assert(!calendar::parse_date("2022-02-29"));
+    assert(!calendar::parse_date("2022-13-01"));
+    assert(!calendar::parse_date("2022-12-31 "));
+    std::istringstream lines("2022-12-31\r\n\nnot a date\n2024-02-29");
+    std::vector<sys_days> dates;
+    assert(calendar::read_dates(lines, dates) == 1);
+    assert(dates == (std::vector<sys_days>{ 2022y / December / 31, 2024y / February / 29 }));
+
+    // Rather than polling like Listing 4.11, schedule the events, and fast-forward a test clock
+    calendar::TestClock::set(one_day_away);
+    calendar::Scheduler<calendar::TestClock> scheduler;
+    std::vector<std::string> fired;
+    scheduler.on(new_years_eve, [&fired] { fired.push_back("new year's eve"); });
+    auto cancelled = scheduler.on(2023y / January / 1, [&fired] { fired.push_back("new year's day"); });
+    scheduler.at(calendar::TestClock::now() + 12h, [&fired] { fired.push_back("half way"); });
+    calendar::TestClock::advance(12h - 1s);
+    scheduler.poll();
+    assert(fired.empty());
+    calendar::TestClock::advance(12h + 1s);
+    scheduler.poll();
+    assert(fired == (std::vector<std::string>{ "half way", "new year's eve" }));
+    assert(scheduler.cancel(cancelled));
+    calendar::TestClock::advance(days{ 1 });
+    scheduler.poll();
+    assert(fired.size() == 2);
+}
+
+// Not in the text: times countdown_in_local_time with and without the cached zone, for every day of a year
+void benchmark_local_time(std::ostream& s)
+{
+    using namespace std::chrono;
+    const auto now = system_clock::now();
+    std::vector<year_month_day> dates;
+    for (sys_days day = 2024y / January / 1; day < sys_days{ 2025y / January / 1 }; day += days{ 1 })
+    {
+        dates.push_back(day);
+    }
+    constexpr int repeats = 100;
+
+    auto before = steady_clock::now();
+    system_clock::duration total{};
+    for (int repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (auto date : dates)
+        {
+            total += countdown_in_local_time(now, date);
+        }
+    }
+    duration<double, std::nano> uncached = (steady_clock::now() - before) / (dates.size() * repeats);
+
+    before = steady_clock::now();
+    const calendar::ZoneHandle zone;
+    system_clock::duration cached_total{};
+    for (int repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (auto date : dates)
+        {
+            cached_total += countdown_in_local_time(now, date, zone);
+        }
+    }
+    duration<double, std::nano> cached = (steady_clock::now() - before) / (dates.size() * repeats);
+
+    assert(total == cached_total);
+    s << std::format("{} local dates: zoned_time {:.1f}ns, calendar::ZoneHandle {:.1f}ns per date (including setup)\n",
+        dates.size() * repeats, uncached.count(), cached.count());
+}
+
+// Not in the text: countdowns for a big calendar, one countdown_to at a time then as a batch
+void benchmark_batch_countdown(std::ostream& s)
+{
+    using namespace std::chrono;
+    constexpr size_t count = 50'000'000;
+    const auto now = system_clock::now();
+    const sys_days first = 2024y / January / 1;
+    std::vector<sys_days> events(count);
+    for (size_t idx = 0; idx < count; ++idx)
+    {
+        events[idx] = first + days{ static_cast<int>(idx % 3650) };
+    }
+    std::vector<system_clock::duration> durations(count);
+
+    auto before = steady_clock::now();
+    for (size_t idx = 0; idx < count; ++idx)
+    {
+        durations[idx] = countdown_to(now, year_month_day{ events[idx] });
+    }
+    duration<double, std::milli> one_at_a_time = steady_clock::now() - before;
+    const auto expected = durations;
+
+    before = steady_clock::now();
+    calendar::countdowns_to_sequential(now, events, durations);
+    duration<double, std::milli> sequential = steady_clock::now() - before;
+    assert(durations == expected);
+
+    before = steady_clock::now();
+    calendar::countdowns_to(now, events, durations);
+    duration<double, std::milli> parallel = steady_clock::now() - before;
+    assert(durations == expected);
+
+    s << std::format("{} events: countdown_to {:.1f}ms, batch {:.1f}ms, par_unseq batch {:.1f}ms\n",
+        count, one_at_a_time.count(), sequential.count(), parallel.count());
 }
 
-int main()
+// Not in the text: read_date against calendar::parse_date, then a whole feed of dates with calendar::read_dates
+void benchmark_date_parsing(std::ostream& s)
 {
+    using namespace std::chrono;
+    constexpr size_t count = 1'000'000;
+    std::vector<std::string> texts;
+    std::string feed;
+    const sys_days first = 2024y / January / 1;
+    for (size_t idx = 0; idx < count; ++idx)
+    {
+        texts.push_back(std::format("{:%Y-%m-%d}", first + days{ static_cast<int>(idx % 3650) }));
+        feed += texts.back() + '\n';
+    }
+
+    auto before = steady_clock::now();
+    size_t total = 0;
+    for (const auto& text : texts)
+    {
+        std::istringstream in(text);
+        total += static_cast<unsigned>(read_date(in).value().day());
+    }
+    duration<double, std::nano> streamed = (steady_clock::now() - before) / count;
+
+    before = steady_clock::now();
+    size_t fast_total = 0;
+    for (const auto& text : texts)
+    {
+        fast_total += static_cast<unsigned>(calendar::parse_date(text).value().day());
+    }
+    duration<double, std::nano> fast = (steady_clock::now() - before) / count;
+    assert(total == fast_total);
+
+    std::istringstream in(feed);
+    std::vector<sys_days> dates;
+    before = steady_clock::now();
+    calendar::read_dates(in, dates);
+    duration<double> taken = steady_clock::now() - before;
+    assert(dates.size() == count);
+
+    s << std::format("{} dates: read_date {:.1f}ns, calendar::parse_date {:.1f}ns per date, "
+        "calendar::read_dates {:.2f}GB/s\n",
+        count, streamed.count(), fast.count(), feed.size() / taken.count() / 1e9);
+}
+
+// Not in the text: every pay day and month end from 1970 to 2100, worked out and then looked up
+void benchmark_month_table(std::ostream& s)
+{
+    using namespace std::chrono;
+    constexpr int repeats = 1000;
+    std::vector<year_month> months;
+    for (int y = 1970; y <= 2100; ++y)
+    {
+        for (unsigned m = 1; m <= 12; ++m)
+        {
+            months.push_back(year{ y } / month{ m });
+        }
+    }
+
+    auto before = steady_clock::now();
+    unsigned total = 0;
+    for (int repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (auto month : months)
+        {
+            total += static_cast<unsigned>(year_month_day{ month / Friday[last] }.day())
+                + static_cast<unsigned>(year_month_day{ month / last }.day());
+        }
+    }
+    duration<double, std::nano> worked_out = (steady_clock::now() - before) / (months.size() * repeats);
+
+    before = steady_clock::now();
+    unsigned table_total = 0;
+    for (int repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (auto month : months)
+        {
+            table_total += static_cast<unsigned>(calendar::pay_day(month).day())
+                + static_cast<unsigned>(calendar::last_day(month).day());
+        }
+    }
+    duration<double, std::nano> looked_up = (steady_clock::now() - before) / (months.size() * repeats);
+
+    assert(total == table_total);
+    s << std::format("{} months: calendar arithmetic {:.1f}ns, calendar::month_table {:.1f}ns per month\n",
+        months.size() * repeats, worked_out.count(), looked_up.count());
+}
+
+// Run with --bench to time the faster countdowns instead
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string_view(argv[1]) == "--bench")
+    {
+        benchmark_local_time(std::cout);
+        benchmark_batch_countdown(std::cout);
+        benchmark_date_parsing(std::cout);
+        benchmark_month_table(std::cout);
+        return 0;
+    }
+
     //Listing 4,2
     duration_to_end_of_year();
 
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace calendar
+{
+    // The last day and last Friday of every month from FirstYear to LastYear, worked out
+    // by the compiler, in one byte per month: the last day as 28 to 31 in the low two bits,
+    // and the last Friday as 22 to 31 in the next four.
+    // Looking one up is an index rather than calendar arithmetic.
+    template<int FirstYear, int LastYear>
+    class MonthTable
+    {
+    public:
+        static_assert(FirstYear <= LastYear);
+
+        constexpr MonthTable()
+        {
+            using namespace std::chrono;
+            for (int y = FirstYear; y <= LastYear; ++y)
+            {
+                for (unsigned m = 1; m <= 12; ++m)
+                {
+                    const year_month month{ year{ y }, std::chrono::month{ m } };
+                    const unsigned last_day = static_cast<unsigned>((month / last).day());
+                    const unsigned last_friday = static_cast<unsigned>(year_month_day{ month / Friday[last] }.day());
+                    entries_[index(month)] = static_cast<uint8_t>((last_day - 28) | ((last_friday - 22) << 2));
+                }
+            }
+        }
+
+        static constexpr bool contains(std::chrono::year_month month)
+        {
+            return month.ok() && month.year() >= std::chrono::year{ FirstYear } && month.year() <= std::chrono::year{ LastYear };
+        }
+
+        // month must be in the table
+        constexpr std::chrono::day last_day(std::chrono::year_month month) const
+        {
+            return std::chrono::day{ 28u + (entries_[index(month)] & 0x3) };
+        }
+        constexpr std::chrono::day last_friday(std::chrono::year_month month) const
+        {
+            return std::chrono::day{ 22u + (entries_[index(month)] >> 2) };
+        }
+    private:
+        static constexpr size_t index(std::chrono::year_month month)
+        {
+            return static_cast<size_t>(static_cast<int>(month.year()) - FirstYear) * 12
+                + static_cast<unsigned>(month.month()) - 1;
+        }
+
+        std::array<uint8_t, (LastYear - FirstYear + 1) * 12> entries_{};
+    };
+
+    inline constexpr MonthTable<1970, 2100> month_table{};
+
+    // The last Friday of the month, from the table when it can be
+    constexpr std::chrono::year_month_day pay_day(std::chrono::year_month month)
+    {
+        using namespace std::chrono;
+        if (month_table.contains(month))
+        {
+            return month / month_table.last_friday(month);
+        }
+        return year_month_day{ month / Friday[last] };
+    }
+
+    // The last day of the month, from the table when it can be
+    constexpr std::chrono::year_month_day last_day(std::chrono::year_month month)
+    {
+        using namespace std::chrono;
+        if (month_table.contains(month))
+        {
+            return month / month_table.last_day(month);
+        }
+        return year_month_day{ month / last };
+    }
+
+    // Checks every month the table holds against the calendar arithmetic it replaces
+    template<int FirstYear, int LastYear>
+    constexpr bool matches_calendar(const MonthTable<FirstYear, LastYear>& table)
+    {
+        using namespace std::chrono;
+        for (int y = FirstYear; y <= LastYear; ++y)
+        {
+            for (unsigned m = 1; m <= 12; ++m)
+            {
+                const year_month month{ year{ y }, std::chrono::month{ m } };
+                if (month / table.last_day(month) != year_month_day{ month / last }
+                    || month / table.last_friday(month) != year_month_day{ month / Friday[last] })
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Building and checking the table are big constant evaluations, so the project raises MSVC's /constexpr:steps
+    static_assert(sizeof(month_table) == (2100 - 1970 + 1) * 12);
+    static_assert(matches_calendar(month_table));
+}
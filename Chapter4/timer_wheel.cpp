@@ -0,0 +1,168 @@
+#include <algorithm>
+
+#include "timer_wheel.h"
+
+namespace calendar
+{
+    TimerWheel::TimerWheel(uint64_t now)
+        : now_(now)
+    {
+        heads_.fill(none);
+    }
+
+    TimerWheel::Handle TimerWheel::add(uint64_t expiry, Callback callback)
+    {
+        uint32_t index;
+        if (free_.empty())
+        {
+            index = static_cast<uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+        else
+        {
+            index = free_.back();
+            free_.pop_back();
+        }
+        auto& node = nodes_[index];
+        node.expiry = std::max(expiry, now_ + 1); // the slot for now has already gone
+        node.callback = std::move(callback);
+        place(index);
+        ++count_;
+        return { index, node.generation };
+    }
+
+    bool TimerWheel::cancel(Handle handle)
+    {
+        if (handle.index >= nodes_.size())
+        {
+            return false;
+        }
+        auto& node = nodes_[handle.index];
+        if (node.generation != handle.generation || node.slot == none)
+        {
+            return false;
+        }
+        unlink(handle.index);
+        release(handle.index);
+        return true;
+    }
+
+    // The level is the first one whose slots reach the expiry from now.
+    // Anything beyond the last level goes in the slot it will reach soonest, and is placed again then.
+    void TimerWheel::place(uint32_t index)
+    {
+        auto& node = nodes_[index];
+        const uint64_t delta = node.expiry - now_;
+        int level = 0;
+        while (level + 1 < levels && delta >= (uint64_t{ 1 } << (slot_bits * (level + 1))))
+        {
+            ++level;
+        }
+        const uint64_t reach = std::min(node.expiry, now_ + (uint64_t{ 1 } << (slot_bits * levels)) - 1);
+        const uint32_t slot = level * slots + static_cast<uint32_t>((reach >> (slot_bits * level)) & (slots - 1));
+
+        node.slot = slot;
+        ++level_sizes_[level];
+        node.previous = none;
+        node.next = heads_[slot];
+        if (node.next != none)
+        {
+            nodes_[node.next].previous = index;
+        }
+        heads_[slot] = index;
+    }
+
+    void TimerWheel::unlink(uint32_t index)
+    {
+        auto& node = nodes_[index];
+        --level_sizes_[node.slot / slots];
+        if (node.previous != none)
+        {
+            nodes_[node.previous].next = node.next;
+        }
+        else
+        {
+            heads_[node.slot] = node.next;
+        }
+        if (node.next != none)
+        {
+            nodes_[node.next].previous = node.previous;
+        }
+    }
+
+    void TimerWheel::release(uint32_t index)
+    {
+        auto& node = nodes_[index];
+        node.slot = none;
+        node.callback = nullptr;
+        ++node.generation;
+        free_.push_back(index);
+        --count_;
+    }
+
+    // Takes the slot level has just come round to, and places its timers again from now
+    void TimerWheel::cascade(int level)
+    {
+        const uint32_t slot = level * slots + static_cast<uint32_t>((now_ >> (slot_bits * level)) & (slots - 1));
+        uint32_t index = heads_[slot];
+        heads_[slot] = none;
+        while (index != none)
+        {
+            const uint32_t next = nodes_[index].next;
+            --level_sizes_[level];
+            place(index);
+            index = next;
+        }
+    }
+
+    void TimerWheel::advance(uint64_t tick, std::vector<Callback>& due)
+    {
+        if (count_ == 0)
+        {
+            now_ = std::max(now_, tick); // nothing to find on the way
+            return;
+        }
+        while (now_ < tick)
+        {
+            // With the lowest levels empty, nothing happens until the first busy level next comes round
+            int empty = 0;
+            while (level_sizes_[empty] == 0)
+            {
+                ++empty; // count_ isn't 0, so some level has timers
+            }
+            if (empty > 0)
+            {
+                now_ = std::min(tick, now_ | ((uint64_t{ 1 } << (slot_bits * empty)) - 1));
+                if (now_ == tick)
+                {
+                    break;
+                }
+            }
+
+            ++now_;
+            for (int level = levels - 1; level > 0; --level)
+            {
+                if ((now_ & ((uint64_t{ 1 } << (slot_bits * level)) - 1)) == 0)
+                {
+                    cascade(level);
+                }
+            }
+
+            const uint32_t slot = static_cast<uint32_t>(now_ & (slots - 1));
+            for (uint32_t index = heads_[slot]; index != none; )
+            {
+                const uint32_t next = nodes_[index].next;
+                due.push_back(std::move(nodes_[index].callback));
+                --level_sizes_[0];
+                release(index);
+                index = next;
+            }
+            heads_[slot] = none;
+
+            if (count_ == 0)
+            {
+                now_ = tick;
+            }
+        }
+    }
+}
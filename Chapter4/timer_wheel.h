@@ -0,0 +1,206 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace calendar
+{
+    // Timers in four levels of 256 slots, like the hands of a clock:
+    // level 0 holds timers due in the next 256 ticks, one slot per tick,
+    // level 1 one slot per 256 ticks, and so on, covering 2^32 ticks.
+    // When a level comes round, its slot's timers drop down to a finer level.
+    // Adding and cancelling are O(1): each slot is a doubly linked list through a pool of nodes.
+    class TimerWheel
+    {
+    public:
+        using Callback = std::function<void()>;
+
+        // Stays valid after the timer fires or is cancelled; cancelling then does nothing
+        struct Handle
+        {
+            uint32_t index = none;
+            uint32_t generation = 0;
+        };
+
+        explicit TimerWheel(uint64_t now = 0);
+
+        // Timers due now or earlier fire on the next advance
+        Handle add(uint64_t expiry, Callback callback);
+        // false if the timer already fired or was cancelled
+        bool cancel(Handle handle);
+
+        // Moves time on to tick, adding the callback of each timer due by then to due,
+        // earliest first; timers due on the same tick come in no particular order
+        void advance(uint64_t tick, std::vector<Callback>& due);
+
+        uint64_t now() const { return now_; }
+        size_t size() const { return count_; }
+    private:
+        static constexpr uint32_t none = UINT32_MAX;
+        static constexpr int levels = 4;
+        static constexpr int slot_bits = 8;
+        static constexpr uint32_t slots = 1 << slot_bits;
+
+        struct Node
+        {
+            uint64_t expiry = 0;
+            Callback callback;
+            uint32_t previous = none;
+            uint32_t next = none;
+            uint32_t slot = none; // level * slots + slot, or none when free
+            uint32_t generation = 0;
+        };
+
+        void place(uint32_t index);
+        void unlink(uint32_t index);
+        void release(uint32_t index);
+        void cascade(int level);
+
+        std::vector<Node> nodes_;
+        std::vector<uint32_t> free_;
+        std::array<uint32_t, levels * slots> heads_;
+        std::array<size_t, levels> level_sizes_{};
+        uint64_t now_;
+        size_t count_ = 0;
+    };
+
+    // A clock for tests, which only moves when told to, so they can skip ahead instead of sleeping.
+    // It also stands in for system_clock, starting from whatever set gives it.
+    struct TestClock
+    {
+        using duration = std::chrono::steady_clock::duration;
+        using rep = duration::rep;
+        using period = duration::period;
+        using time_point = std::chrono::time_point<TestClock>;
+        static constexpr bool is_steady = true;
+
+        static time_point now() { return time_point{ elapsed }; }
+        static std::chrono::system_clock::time_point system_now() { return start + elapsed; }
+
+        static void set(std::chrono::system_clock::time_point system_time)
+        {
+            start = system_time;
+            elapsed = {};
+        }
+        static void advance(duration by) { elapsed += by; }
+
+        inline static std::chrono::system_clock::time_point start{};
+        inline static duration elapsed{};
+    };
+
+    // Runs callbacks when their time comes, on one thread, from a TimerWheel ticking on Clock.
+    // Times are rounded up to a whole tick, so nothing fires early.
+    template<typename Clock = std::chrono::steady_clock>
+    class Scheduler
+    {
+    public:
+        using Callback = TimerWheel::Callback;
+        using Handle = TimerWheel::Handle;
+
+        explicit Scheduler(typename Clock::duration tick = std::chrono::seconds{ 1 })
+            : tick_(tick), epoch_(Clock::now())
+        {
+        }
+        ~Scheduler()
+        {
+            stop();
+        }
+
+        Handle at(typename Clock::time_point when, Callback callback)
+        {
+            const auto ticks = (when - epoch_ + tick_ - typename Clock::duration{ 1 }) / tick_;
+            std::lock_guard lock{ mutex_ };
+            return wheel_.add(static_cast<uint64_t>(std::max<decltype(ticks)>(ticks, 0)), std::move(callback));
+        }
+
+        // A system_clock time, such as the countdown functions use
+        template<typename Duration>
+        Handle at(std::chrono::sys_time<Duration> when, Callback callback)
+        {
+            const auto from_now = std::chrono::ceil<typename Clock::duration>(when - system_now());
+            return at(Clock::now() + from_now, std::move(callback));
+        }
+
+        // The start of a day, in UTC
+        Handle on(std::chrono::year_month_day date, Callback callback)
+        {
+            return at(std::chrono::sys_days{ date }, std::move(callback));
+        }
+
+        bool cancel(Handle handle)
+        {
+            std::lock_guard lock{ mutex_ };
+            return wheel_.cancel(handle);
+        }
+
+        // Runs everything due by Clock::now(), on this thread.
+        // Callbacks run without the lock held, so they can add or cancel timers.
+        void poll()
+        {
+            std::vector<Callback> due;
+            {
+                std::lock_guard lock{ mutex_ };
+                wheel_.advance(static_cast<uint64_t>((Clock::now() - epoch_) / tick_), due);
+            }
+            for (auto& callback : due)
+            {
+                callback();
+            }
+        }
+
+        // Polls once a tick on a thread of its own, until stop
+        void start()
+        {
+            thread_ = std::jthread([this](std::stop_token stop) {
+                while (!stop.stop_requested())
+                {
+                    poll();
+                    std::unique_lock lock{ mutex_ };
+                    const auto deadline = epoch_ + tick_ * static_cast<typename Clock::rep>(wheel_.now() + 1);
+                    wake_.wait_until(lock, stop, deadline, [] { return false; });
+                }
+            });
+        }
+
+        void stop()
+        {
+            if (thread_.joinable())
+            {
+                thread_.request_stop();
+                thread_.join();
+            }
+        }
+
+        size_t size() const
+        {
+            std::lock_guard lock{ mutex_ };
+            return wheel_.size();
+        }
+    private:
+        static std::chrono::system_clock::time_point system_now()
+        {
+            if constexpr (requires { Clock::system_now(); })
+            {
+                return Clock::system_now();
+            }
+            else
+            {
+                return std::chrono::system_clock::now();
+            }
+        }
+
+        typename Clock::duration tick_;
+        typename Clock::time_point epoch_;
+        mutable std::mutex mutex_;
+        std::condition_variable_any wake_;
+        TimerWheel wheel_;
+        std::jthread thread_;
+    };
+}
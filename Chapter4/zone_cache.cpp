@@ -0,0 +1,42 @@
+#include <algorithm>
+
+#include "zone_cache.h"
+
+namespace calendar
+{
+    ZoneHandle::ZoneHandle(const std::chrono::time_zone* zone, std::chrono::year from, std::chrono::year to)
+        : zone_(zone), end_(std::chrono::sys_days{ to / std::chrono::January / 1 })
+    {
+        using namespace std::chrono;
+        sys_seconds start = sys_days{ from / January / 1 };
+        while (start < end_)
+        {
+            const sys_info info = zone_->get_info(start);
+            sys_begins_.push_back(start);
+            local_begins_.push_back(local_seconds{ start.time_since_epoch() + info.offset });
+            offsets_.push_back(info.offset);
+            start = info.end;
+        }
+    }
+
+    std::chrono::sys_seconds ZoneHandle::to_sys(std::chrono::local_seconds local) const
+    {
+        using namespace std::chrono;
+        if (local_begins_.empty() || local < local_begins_.front())
+        {
+            return zone_->to_sys(local);
+        }
+        // the last interval starting, in local time, no later than local
+        const size_t idx = std::ranges::upper_bound(local_begins_, local) - local_begins_.begin() - 1;
+        const sys_seconds sys{ local.time_since_epoch() - offsets_[idx] };
+
+        const sys_seconds interval_end = idx + 1 < sys_begins_.size() ? sys_begins_[idx + 1] : end_;
+        const bool skipped = sys >= interval_end; // clocks went forward over local, or it's beyond the cache
+        const bool repeated = idx > 0 && sys < sys_begins_[idx] + (offsets_[idx - 1] - offsets_[idx]);
+        if (skipped || repeated)
+        {
+            return zone_->to_sys(local);
+        }
+        return sys;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+namespace calendar
+{
+    // Looks up a time zone once, then keeps the UTC offset for each interval
+    // between its transitions over a range of years, in flat arrays.
+    // Turning a local time into a sys time is then a binary search,
+    // rather than a tzdb search on every call like zoned_time.
+    class ZoneHandle
+    {
+    public:
+        explicit ZoneHandle(const std::chrono::time_zone* zone = std::chrono::current_zone(),
+            std::chrono::year from = std::chrono::year{ 1970 },
+            std::chrono::year to = std::chrono::year{ 2100 });
+
+        const std::chrono::time_zone* zone() const { return zone_; }
+
+        // The same as zoned_time(zone(), local).get_sys_time().
+        // Times outside the cached years, or skipped or repeated when the clocks change,
+        // go to the time_zone itself, so they throw just as zoned_time would.
+        std::chrono::sys_seconds to_sys(std::chrono::local_seconds local) const;
+    private:
+        const std::chrono::time_zone* zone_;
+        std::chrono::sys_seconds end_; // where the cached intervals stop
+        // interval i starts at sys_begins_[i], or local_begins_[i] in local time, with offsets_[i]
+        std::vector<std::chrono::local_seconds> local_begins_;
+        std::vector<std::chrono::sys_seconds> sys_begins_;
+        std::vector<std::chrono::seconds> offsets_;
+    };
+}
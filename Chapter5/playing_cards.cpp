@@ -2,15 +2,14 @@
 #include <random>
 
 #include "playing_cards.h"
+#include "random_engine.h"
 
 namespace cards
 {
 	// After Listing 5.29, we noticed the repetition, so said we wcould write a function template instead of having two shuffle functions:
 	template<typename T> void shuffle_either_deck(T& deck)
 	{
-		std::random_device rd;
-		std::mt19937 gen{ rd() };
-		std::ranges::shuffle(deck, gen);
+		std::ranges::shuffle(deck, rng::engine());
 	}
 
 
@@ -135,9 +134,7 @@ namespace cards
 	// Listing 5.22 Shuffle the cards
 	void shuffle_deck(std::array<Card, 52>& deck)
 	{
-		std::random_device rd;
-		std::mt19937 gen{ rd() };
-		std::ranges::shuffle(deck, gen);
+		std::ranges::shuffle(deck, rng::engine());
 	}
 
 	// Listing 5.23 Is the guess correct?
@@ -183,9 +180,7 @@ namespace cards
 	//Listing 5.28 Shuffle an extended deck
 	void shuffle_deck(std::array<std::variant<Card, Joker>, 54>& deck)
 	{
-		std::random_device rd;
-		std::mt19937 gen{ rd() };
-		std::ranges::shuffle(deck, gen);
+		std::ranges::shuffle(deck, rng::engine());
 	}
 
 	//Listing 5.30 Is the guess correct for an extended deck
@@ -17,6 +17,8 @@
 #include <variant>
 #include <vector>
 
+#include "random_engine.h"
+
 using Reel = std::vector<int>;
 
 // Listing 9.1 Make the first few triangle numbers
@@ -133,8 +135,7 @@ void triangle_machine_spins_only()
 {
 	constexpr int numbers = 20;
 	constexpr size_t number_of_reels = 3u;
-	std::random_device rd;
-	std::mt19937 gen{ rd() };
+	auto& gen = rng::engine();
 	auto shuffle = [&gen](auto begin, auto end) { std::shuffle(begin, end, gen); };
 	std::vector<Reel> reels = make_reels(numbers, number_of_reels, shuffle);
 
@@ -299,8 +300,7 @@ void triangle_machine()
 {
 	constexpr int numbers = 20;
 	constexpr size_t number_of_reels = 3u;
-	std::random_device rd;
-	std::mt19937 gen{ rd() };
+	auto& gen = rng::engine();
 	auto shuffle = [&gen](auto begin, auto end) { std::shuffle(begin, end, gen); };
 	std::vector<Reel> reels = make_reels(numbers, number_of_reels, shuffle);
 
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+// Shared by the chapters that need it, which add this directory to their include paths
+namespace rng
+{
+	// xoshiro256++ (Blackman and Vigna): 32 bytes of state and a few adds, shifts and rotates per number,
+	// where std::mt19937 has 5KB of state to set up.
+	// Meets UniformRandomBitGenerator, so works with the std distributions and std::shuffle.
+	class Xoshiro256
+	{
+	public:
+		using result_type = uint64_t;
+
+		explicit Xoshiro256(uint64_t seed = 0)
+		{
+			reseed(seed);
+		}
+
+		// Fills the state from splitmix64, so similar seeds still give unrelated sequences
+		void reseed(uint64_t seed)
+		{
+			for (auto& word : state_)
+			{
+				seed += 0x9E3779B97F4A7C15;
+				uint64_t z = seed;
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+				word = z ^ (z >> 31);
+			}
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+		result_type operator()()
+		{
+			const uint64_t result = std::rotl(state_[0] + state_[3], 23) + state_[0];
+			const uint64_t t = state_[1] << 17;
+			state_[2] ^= state_[0];
+			state_[3] ^= state_[1];
+			state_[1] ^= state_[2];
+			state_[0] ^= state_[3];
+			state_[2] ^= t;
+			state_[3] = std::rotl(state_[3], 45);
+			return result;
+		}
+
+		// Moves on 2^128 numbers, as if operator() had been called that many times
+		void jump()
+		{
+			constexpr uint64_t polynomial[] = { 0x180EC6D33CFD0ABA, 0xD5A61266F0C9392C,
+				0xA9582618E03FC9AA, 0x39ABDC4529B1661C };
+			uint64_t jumped[4]{};
+			for (uint64_t word : polynomial)
+			{
+				for (int bit = 0; bit < 64; ++bit)
+				{
+					if (word & (uint64_t{ 1 } << bit))
+					{
+						for (int idx = 0; idx < 4; ++idx)
+						{
+							jumped[idx] ^= state_[idx];
+						}
+					}
+					(*this)();
+				}
+			}
+			for (int idx = 0; idx < 4; ++idx)
+			{
+				state_[idx] = jumped[idx];
+			}
+		}
+
+		// Hands out the next 2^128 numbers as a separate engine and jumps past them.
+		// Splitting one seeded engine once per thread gives reproducible, non-overlapping parallel runs.
+		Xoshiro256 split()
+		{
+			Xoshiro256 stream = *this;
+			jump();
+			return stream;
+		}
+
+		friend bool operator==(const Xoshiro256&, const Xoshiro256&) = default;
+	private:
+		uint64_t state_[4];
+	};
+
+	// Each thread's engine, seeded from std::random_device the first time that thread asks for it
+	inline Xoshiro256& engine()
+	{
+		thread_local Xoshiro256 generator{ (uint64_t{ std::random_device{}() } << 32) | std::random_device{}() };
+		return generator;
+	}
+
+	// For a repeatable run: sets this thread's engine back to a known seed
+	inline void reseed(uint64_t seed)
+	{
+		engine().reseed(seed);
+	}
+}